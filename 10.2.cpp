@@ -1,12 +1,13 @@
+#include "10.h"
 #include "h.h"
 
 #include <algorithm>
-#include <cmath>
 #include <cstdint>
-#include <fstream>
+#include <cstdlib>
 #include <functional>
 #include <iostream>
-#include <ranges>
+#include <optional>
+#include <unordered_map>
 #include <vector>
 
 namespace
@@ -14,56 +15,8 @@ namespace
 
 using namespace std::string_view_literals;
 
-enum class Type : std::uint8_t
-{
-	Ground, // .
-	Vertical, // |
-	Horisontal, // -
-	NorthToEast, // L
-	NorthToWest, // J
-	SouthToWest, // 7
-	SouthToEast, // F
-	Animal, // S
-};
-
-const std::unordered_map<char, Type> symbol_to_type = {
-	{'.', Type::Ground},
-	{'|', Type::Vertical},
-	{'-', Type::Horisontal},
-	{'L', Type::NorthToEast},
-	{'J', Type::NorthToWest},
-	{'7', Type::SouthToWest},
-	{'F', Type::SouthToEast},
-	{'S', Type::Animal},
-};
-
-Type to_type(const char ch)
-{
-	return symbol_to_type.at(ch);
-}
-
-char to_symbol(Type type)
-{
-	for (const auto & [k, v] : symbol_to_type)
-	{
-		if (v == type)
-		{
-			return k;
-		}
-	}
-	throw std::logic_error("Unknown type");
-}
-
-std::vector<Type> process_line(std::string_view line)
-{
-	std::vector<Type> result(line.size() + 2);
-	result.front() = result.back() = Type::Ground;
-	const auto r = line | std::ranges::views::transform(to_type);
-	std::ranges::copy(r, std::next(result.begin()));
-	return result;
-}
-
-using Map = std::vector<std::vector<Type>>;
+using day10::Type;
+using day10::to_symbol;
 
 struct Coordinate
 {
@@ -84,173 +37,6 @@ struct Point
 	}
 };
 
-class Cursor
-{
-public:
-	explicit Cursor(const Map & map)
-		: map_(map)
-	{
-	}
-
-	Point start()
-	{
-		seek_to_animal();
-		Point result = current();
-
-		if (
-			[](Type type)
-			{
-				return type == Type::SouthToEast || type == Type::Vertical || type == Type::SouthToWest;
-			}(map_[i_ - 1][j_]))
-		{
-			cmp_with_prev_i_ = -1;
-			--i_;
-		}
-		else if (
-			[](Type type)
-			{
-				return type == Type::NorthToWest || type == Type::Vertical || type == Type::NorthToEast;
-			}(map_[i_ + 1][j_]))
-		{
-			cmp_with_prev_i_ = 1;
-			++i_;
-		}
-		else if (
-			[](Type type)
-			{
-				return type == Type::NorthToEast || type == Type::Horisontal || type == Type::SouthToEast;
-			}(map_[i_][j_ - 1]))
-		{
-			cmp_with_prev_j_ = -1;
-			--j_;
-		}
-		else if (
-			[](Type type)
-			{
-				return type == Type::NorthToWest || type == Type::Horisontal || type == Type::SouthToWest;
-			}(map_[i_][j_ + 1]))
-		{
-			cmp_with_prev_j_ = 1;
-			++j_;
-		}
-		else
-		{
-			throw std::logic_error("No way");
-		}
-		return result;
-	}
-
-	Point current() const
-	{
-		return {{i_, j_}, map_[i_][j_]};
-	}
-
-	std::optional<Point> next()
-	{
-		switch (map_[i_][j_])
-		{
-		case Type::Vertical:
-			i_ += cmp_with_prev_i_;
-			break;
-
-		case Type::Horisontal:
-			j_ += cmp_with_prev_j_;
-			break;
-
-		case Type::NorthToEast:
-			if (cmp_with_prev_i_ > 0)
-			{
-				++j_;
-				cmp_with_prev_i_ = 0;
-				cmp_with_prev_j_ = 1;
-			}
-			else
-			{
-				--i_;
-				cmp_with_prev_i_ = -1;
-				cmp_with_prev_j_ = 0;
-			}
-			break;
-
-		case Type::NorthToWest:
-			if (cmp_with_prev_i_ > 0)
-			{
-				--j_;
-				cmp_with_prev_i_ = 0;
-				cmp_with_prev_j_ = -1;
-			}
-			else
-			{
-				--i_;
-				cmp_with_prev_i_ = -1;
-				cmp_with_prev_j_ = 0;
-			}
-			break;
-
-		case Type::SouthToWest:
-			if (cmp_with_prev_i_ < 0)
-			{
-				--j_;
-				cmp_with_prev_i_ = 0;
-				cmp_with_prev_j_ = -1;
-			}
-			else
-			{
-				++i_;
-				cmp_with_prev_i_ = 1;
-				cmp_with_prev_j_ = 0;
-			}
-			break;
-
-		case Type::SouthToEast:
-			if (cmp_with_prev_i_ < 0)
-			{
-				++j_;
-				cmp_with_prev_i_ = 0;
-				cmp_with_prev_j_ = 1;
-			}
-			else
-			{
-				++i_;
-				cmp_with_prev_i_ = 1;
-				cmp_with_prev_j_ = 0;
-			}
-			break;
-
-		case Type::Ground:
-			throw std::logic_error("Path to ground");
-		case Type::Animal:
-			throw std::logic_error("Next without start");
-		}
-
-		return map_[i_][j_] != Type::Animal ? std::optional(Point{{i_, j_}, map_[i_][j_]}) : std::nullopt;
-	}
-
-private:
-	void seek_to_animal()
-	{
-		for (std::size_t i = 0; i < map_.size(); ++i)
-		{
-			for (std::size_t j = 0; j < map_[i].size(); ++j)
-			{
-				if (map_[i][j] == Type::Animal)
-				{
-					i_ = i;
-					j_ = j;
-					return;
-				}
-			}
-		}
-	}
-
-private:
-	const Map & map_;
-	std::size_t i_ = 0;
-	int cmp_with_prev_i_ = 0;
-	std::size_t j_ = 0;
-	int cmp_with_prev_j_ = 0;
-};
-
 } // namespace
 
 template <>
@@ -358,50 +144,20 @@ private:
 	std::vector<Point> points_;
 };
 
-} // namespace
-
-int task_10_2(std::string_view input_file)
+unsigned count_by_ray_casting(const day10::Grid & grid)
 {
-	std::ifstream input(input_file.data());
-
-	std::vector<std::vector<Type>> map;
-	std::string line;
-	std::getline(input, line);
-	std::size_t real_line_len = line.size();
-	map.emplace_back(real_line_len + 2, Type::Ground);
-	map.push_back(process_line(line));
-	while (!input.bad() && !input.eof())
-	{
-		std::getline(input, line);
-		map.push_back(process_line(line));
-	}
-	map.emplace_back(line.size() + 2, Type::Ground);
-
-	for (const auto & row : map)
-	{
-		for (const auto & cell : row)
-		{
-			std::cout << to_symbol(cell);
-		}
-		std::cout << '\n';
-	}
-
 	Contour contour;
-	Cursor cursor(map);
-	contour.push_back(cursor.start());
-	contour.push_back(cursor.current());
-	std::cout << to_symbol(cursor.current().type) << '\n';
-	while (auto point = cursor.next())
-	{
-		contour.push_back(*point);
-		std::cout << to_symbol(cursor.current().type) << '\n';
-	}
-	std::cout << "====\n";
+	day10::walk_loop(
+		grid,
+		[&](std::size_t pos, day10::Direction)
+		{
+			contour.push_back(Point{{pos / grid.stride(), pos % grid.stride()}, grid[pos]});
+		});
 
 	unsigned result = 0;
-	for (std::size_t i = 1; i <= map.size() - 2; ++i)
+	for (std::size_t i = 1; i <= grid.height(); ++i)
 	{
-		for (std::size_t j = 1; j <= real_line_len + 1; ++j)
+		for (std::size_t j = 1; j <= grid.width(); ++j)
 		{
 			if (const auto type = contour.get_type(i, j))
 			{
@@ -409,8 +165,9 @@ int task_10_2(std::string_view input_file)
 				continue;
 			}
 			unsigned intersections_count = 0;
-			std::optional<int> prev_intersection;
-			for (std::size_t jj = j + 1; jj <= real_line_len + 1; ++jj)
+			// Direction of the unmatched corner seen last (-1 north, 1 south), or 0 if there is none.
+			int prev_intersection = 0;
+			for (std::size_t jj = j + 1; jj <= grid.width(); ++jj)
 			{
 				const auto intesection = contour.is_intersection(i, jj);
 				if (!intesection)
@@ -420,15 +177,15 @@ int task_10_2(std::string_view input_file)
 				if (*intesection == 0)
 				{
 					intersections_count += 1;
-					prev_intersection.reset();
+					prev_intersection = 0;
 					continue;
 				}
 				if (!prev_intersection)
 				{
-					prev_intersection = intesection;
+					prev_intersection = *intesection;
 					continue;
 				}
-				if (prev_intersection == intesection)
+				if (prev_intersection == *intesection)
 				{
 					intersections_count += 2;
 				}
@@ -436,7 +193,7 @@ int task_10_2(std::string_view input_file)
 				{
 					intersections_count += 1;
 				}
-				prev_intersection.reset();
+				prev_intersection = 0;
 			}
 			unsigned not_even = intersections_count % 2;
 			std::cout << (not_even ? '$' : '*');
@@ -445,7 +202,59 @@ int task_10_2(std::string_view input_file)
 		std::cout << '\n';
 	}
 
-	std::cout << result << '\n';
+	return result;
+}
+
+// The shoelace formula over the loop gives twice its area, and Pick's theorem A = I + B/2 - 1 turns the area and the
+// loop length B into the count of enclosed tiles, with no per-cell work. The area does not depend on where the loop
+// is, so coordinates start at zero on the animal.
+std::int64_t count_by_pick(const day10::Grid & grid)
+{
+	std::int64_t row = 0;
+	std::int64_t col = 0;
+	std::int64_t twice_area = 0;
+	const std::size_t len = day10::walk_loop(
+		grid,
+		[&](std::size_t, day10::Direction out)
+		{
+			const std::int64_t row_step = day10::row_steps[out];
+			const std::int64_t col_step = day10::col_steps[out];
+			twice_area += row * col_step - col * row_step;
+			row += row_step;
+			col += col_step;
+		});
+	return (std::abs(twice_area) - static_cast<std::int64_t>(len)) / 2 + 1;
+}
+
+enum class Method
+{
+	RayCasting,
+	Pick,
+};
+
+int solve(std::string_view input_file, Method method)
+{
+	const day10::Grid grid = day10::read_grid(input_file);
+	if (method == Method::RayCasting)
+	{
+		std::cout << count_by_ray_casting(grid) << '\n';
+	}
+	else
+	{
+		std::cout << count_by_pick(grid) << '\n';
+	}
 
 	return 0;
 }
+
+} // namespace
+
+int task_10_2(std::string_view input_file)
+{
+	return solve(input_file, Method::RayCasting);
+}
+
+int task_10_2_pick(std::string_view input_file)
+{
+	return solve(input_file, Method::Pick);
+}
@@ -0,0 +1,240 @@
+#pragma once
+
+#include <array>
+#include <cstddef>
+#include <cstdint>
+#include <fstream>
+#include <stdexcept>
+#include <string>
+#include <string_view>
+#include <utility>
+#include <vector>
+
+// Pipe maze shared by both parts of day 10.
+namespace day10
+{
+
+enum class Type : std::uint8_t
+{
+	Ground, // .
+	Vertical, // |
+	Horisontal, // -
+	NorthToEast, // L
+	NorthToWest, // J
+	SouthToWest, // 7
+	SouthToEast, // F
+	Animal, // S
+};
+
+constexpr std::string_view symbols = ".|-LJ7FS";
+
+constexpr char to_symbol(Type type)
+{
+	return symbols[static_cast<std::size_t>(type)];
+}
+
+// Direction of travel. Stop marks a pipe that cannot be entered that way, and the animal, where the loop closes.
+enum Direction : std::uint8_t
+{
+	North,
+	East,
+	South,
+	West,
+	Stop,
+};
+
+constexpr std::array<int, 4> row_steps = {-1, 0, 1, 0};
+constexpr std::array<int, 4> col_steps = {0, 1, 0, -1};
+
+namespace detail
+{
+
+constexpr std::uint8_t no_type = 0xFF;
+
+constexpr std::array<std::uint8_t, 256> make_types()
+{
+	std::array<std::uint8_t, 256> result{};
+	result.fill(no_type);
+	for (std::size_t type = 0; type < symbols.size(); ++type)
+	{
+		result[static_cast<unsigned char>(symbols[type])] = static_cast<std::uint8_t>(type);
+	}
+	return result;
+}
+
+constexpr std::array<std::uint8_t, 256> types = make_types();
+
+using Turns = std::array<std::array<Direction, 4>, 8>;
+
+constexpr Turns make_turns()
+{
+	Turns result{};
+	for (auto & row : result)
+	{
+		row.fill(Stop);
+	}
+	const auto set = [&result](Type type, Direction in, Direction out)
+	{
+		result[static_cast<std::size_t>(type)][in] = out;
+	};
+	set(Type::Vertical, North, North);
+	set(Type::Vertical, South, South);
+	set(Type::Horisontal, East, East);
+	set(Type::Horisontal, West, West);
+	set(Type::NorthToEast, South, East);
+	set(Type::NorthToEast, West, North);
+	set(Type::NorthToWest, South, West);
+	set(Type::NorthToWest, East, North);
+	set(Type::SouthToWest, North, West);
+	set(Type::SouthToWest, East, South);
+	set(Type::SouthToEast, North, East);
+	set(Type::SouthToEast, West, South);
+	return result;
+}
+
+} // namespace detail
+
+// Direction a walk leaves a cell of `type` in after entering it travelling `in`.
+constexpr detail::Turns turns = detail::make_turns();
+
+static_assert(turns[static_cast<std::size_t>(Type::SouthToEast)][North] == East);
+static_assert(turns[static_cast<std::size_t>(Type::Ground)][North] == Stop);
+
+// Row-major grid with a border of ground, so every neighbour of a real cell exists and moving is adding an offset.
+class Grid
+{
+public:
+	Grid(std::vector<Type> cells, std::size_t width, std::size_t height)
+		: cells_(std::move(cells))
+		, width_(width)
+		, height_(height)
+		, offsets_{
+			  -static_cast<std::ptrdiff_t>(stride()),
+			  1,
+			  static_cast<std::ptrdiff_t>(stride()),
+			  -1,
+		  }
+	{
+	}
+
+	std::size_t width() const
+	{
+		return width_;
+	}
+
+	std::size_t height() const
+	{
+		return height_;
+	}
+
+	std::size_t stride() const
+	{
+		return width_ + 2;
+	}
+
+	Type operator[](std::size_t pos) const
+	{
+		return cells_[pos];
+	}
+
+	std::size_t step(std::size_t pos, Direction direction) const
+	{
+		return pos + offsets_[direction];
+	}
+
+	std::size_t find_animal() const
+	{
+		for (std::size_t pos = 0; pos < cells_.size(); ++pos)
+		{
+			if (cells_[pos] == Type::Animal)
+			{
+				return pos;
+			}
+		}
+		throw std::logic_error("No animal");
+	}
+
+	// First direction from `pos` into a pipe that connects back.
+	Direction exit(std::size_t pos) const
+	{
+		for (const Direction direction : {North, South, West, East})
+		{
+			if (turns[static_cast<std::size_t>(cells_[step(pos, direction)])][direction] != Stop)
+			{
+				return direction;
+			}
+		}
+		throw std::logic_error("No way");
+	}
+
+private:
+	std::vector<Type> cells_;
+	std::size_t width_;
+	std::size_t height_;
+	std::array<std::ptrdiff_t, 4> offsets_;
+};
+
+inline Grid read_grid(std::string_view input_file)
+{
+	std::ifstream input(input_file.data());
+
+	std::vector<std::string> lines;
+	std::string line;
+	while (std::getline(input, line))
+	{
+		if (!line.empty())
+		{
+			lines.push_back(std::move(line));
+		}
+	}
+	if (lines.empty())
+	{
+		throw std::logic_error("Empty map");
+	}
+
+	const std::size_t width = lines.front().size();
+	const std::size_t stride = width + 2;
+	std::vector<Type> cells(stride * (lines.size() + 2), Type::Ground);
+	for (std::size_t i = 0; i < lines.size(); ++i)
+	{
+		if (lines[i].size() != width)
+		{
+			throw std::invalid_argument("Ragged map line \"" + lines[i] + '"');
+		}
+		for (std::size_t j = 0; j < width; ++j)
+		{
+			const std::uint8_t type = detail::types[static_cast<unsigned char>(lines[i][j])];
+			if (type == detail::no_type)
+			{
+				throw std::invalid_argument("Bad map line \"" + lines[i] + '"');
+			}
+			cells[(i + 1) * stride + j + 1] = static_cast<Type>(type);
+		}
+	}
+	return {std::move(cells), width, lines.size()};
+}
+
+// Walks the loop from the animal and calls `f(pos, out)` for every cell on it, starting with the animal's, where `out`
+// is the direction the walk leaves the cell in. Each step is a table load and an add. Returns the loop length.
+template <typename F>
+std::size_t walk_loop(const Grid & grid, F && f)
+{
+	std::size_t pos = grid.find_animal();
+	Direction direction = grid.exit(pos);
+	std::size_t len = 0;
+	do
+	{
+		f(pos, direction);
+		pos = grid.step(pos, direction);
+		direction = turns[static_cast<std::size_t>(grid[pos])][direction];
+		++len;
+	}
+	while (direction != Stop);
+	if (grid[pos] != Type::Animal)
+	{
+		throw std::logic_error("Path to ground");
+	}
+	return len;
+}
+
+} // namespace day10
@@ -1,63 +1,90 @@
+#include "3.h"
+#include "common.h"
 #include "h.h"
 
-#include <fstream>
+#include <algorithm>
+#include <array>
+#include <cstdint>
+#include <cstring>
 #include <iostream>
+#include <limits>
+#include <stdexcept>
+#include <tuple>
 
 namespace
 {
 
-bool is_part_number(
-	std::string_view line1,
-	std::string_view line2,
-	std::string_view line3,
-	std::size_t number_start,
-	std::size_t number_end)
+struct RowMasks
 {
-	if (number_start)
+	day3::Mask digits;
+	day3::Mask symbols;
+};
+
+void build_masks(std::string_view row, RowMasks & masks)
+{
+	const std::size_t words = (row.size() + 63) / 64;
+	masks.digits.assign(words, 0);
+	masks.symbols.assign(words, 0);
+	for (std::size_t offset = 0; offset < row.size(); offset += 8)
 	{
-		if (line1[number_start - 1] != '.' || line2[number_start - 1] != '.' || line3[number_start - 1] != '.')
-		{
-			return true;
-		}
+		std::uint64_t chunk = day3::broadcast('.');
+		std::memcpy(&chunk, row.data() + offset, std::min<std::size_t>(8, row.size() - offset));
+		const std::uint64_t digits = day3::digit_bytes(chunk);
+		const std::uint64_t symbols = ~(digits | day3::equal_bytes(chunk, '.'));
+		masks.digits[offset / 64] |= day3::gather(digits) << (offset % 64);
+		masks.symbols[offset / 64] |= day3::gather(symbols) << (offset % 64);
 	}
-	for (std::size_t i = number_start; i <= number_end; ++i)
+}
+
+std::uint64_t checked_add(std::uint64_t lhs, std::uint64_t rhs)
+{
+	if (rhs > std::numeric_limits<std::uint64_t>::max() - lhs)
 	{
-		if (line1[i] != '.' || line3[i] != '.')
-		{
-			return true;
-		}
+		throw std::overflow_error("Sum of part numbers does not fit into 64 bits");
 	}
-	if (number_end != line1.size() - 1)
-	{
-		if (line1[number_end + 1] != '.' || line2[number_end + 1] != '.' || line3[number_end + 1] != '.')
+	return lhs + rhs;
+}
+
+std::uint64_t process_lines(
+	std::string_view line,
+	const RowMasks & above,
+	const RowMasks & current,
+	const RowMasks & below,
+	day3::Mask & near_symbol)
+{
+	day3::dilate(near_symbol, above.symbols, current.symbols, below.symbols);
+
+	std::uint64_t result = 0;
+	day3::for_each_number(
+		current.digits,
+		[&](std::size_t first, std::size_t last)
 		{
-			return true;
-		}
-	}
-	return false;
+			if (day3::any_bit(near_symbol, first, last))
+			{
+				result = checked_add(result, day3::parse_part_number(line.substr(first, last - first)));
+			}
+		});
+	return result;
 }
 
-unsigned process_lines(std::string_view line1, std::string_view line2, std::string_view line3)
+std::uint64_t process_band(const day3::Schematic & schematic, std::size_t first, std::size_t last)
 {
-	unsigned result = 0;
-	std::size_t i = 0;
-	while (true)
+	std::array<RowMasks, 3> masks;
+	std::size_t above = 0;
+	std::size_t current = 1;
+	std::size_t below = 2;
+	day3::Mask near_symbol;
+	build_masks(schematic.row(first - 1), masks[above]);
+	build_masks(schematic.row(first), masks[current]);
+
+	std::uint64_t result = 0;
+	for (std::size_t i = first; i < last; ++i)
 	{
-		std::size_t number_start = line2.find_first_of("0123456789", i);
-		if (number_start == std::string_view::npos)
-		{
-			break;
-		}
-		i = number_start;
-		while (std::isdigit(line2[i]))
-		{
-			++i;
-		};
-		unsigned number = atoi(line2.substr(number_start, i - number_start).data());
-		if (is_part_number(line1, line2, line3, number_start, i - 1))
-		{
-			result += number;
-		}
+		build_masks(schematic.row(i + 1), masks[below]);
+		result = checked_add(
+			result,
+			process_lines(schematic.row(i), masks[above], masks[current], masks[below], near_symbol));
+		std::tie(above, current, below) = std::tuple(current, below, above);
 	}
 	return result;
 }
@@ -66,22 +93,20 @@ unsigned process_lines(std::string_view line1, std::string_view line2, std::stri
 
 int task_3_1(std::string_view input_file)
 {
-	std::ifstream input(input_file.data());
-	std::string line1, line2, line3;
-	unsigned result = 0;
+	const aoc::MappedFile file(input_file.data());
+	const day3::Schematic schematic(file.view());
 
-	std::getline(input, line2);
-	line1 = std::string(line2.size(), '.');
-
-	while (!input.bad() && !input.eof())
+	const auto bands = aoc::run_bands(
+		schematic.height(),
+		[&schematic](std::size_t first, std::size_t last)
+		{
+			return process_band(schematic, first, last);
+		});
+	std::uint64_t result = 0;
+	for (const std::uint64_t band : bands)
 	{
-		std::getline(input, line3);
-		result += process_lines(line1, line2, line3);
-		line1 = std::move(line2);
-		line2 = std::move(line3);
+		result = checked_add(result, band);
 	}
-	line3 = std::string(line2.size(), '.');
-	result += process_lines(line1, line2, line3);
 
 	std::cout << result << '\n';
 	return 0;
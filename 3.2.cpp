@@ -1,159 +1,254 @@
+#include "3.h"
+#include "common.h"
 #include "h.h"
 
+#include <algorithm>
 #include <array>
-#include <fstream>
+#include <cstdint>
+#include <cstring>
 #include <iostream>
-#include <unordered_map>
+#include <limits>
+#include <stdexcept>
+#include <tuple>
+#include <vector>
 
 namespace
 {
 
-constexpr std::size_t max_part_number_len = 3;
-constexpr std::size_t max_adjacent_parts = 3 * (max_part_number_len + 2) + 2;
+// Rows of the three-row window (text masks and gear state alike) are addressed by slot.
+struct Window
+{
+	std::size_t above = 0;
+	std::size_t current = 1;
+	std::size_t below = 2;
 
-std::array<int, max_adjacent_parts> get_gear_idx(
-	std::size_t cur_line,
-	std::string_view line1,
-	std::string_view line2,
-	std::string_view line3,
-	std::size_t number_start,
-	std::size_t number_end)
+	void rotate()
+	{
+		std::tie(above, current, below) = std::tuple(current, below, above);
+	}
+};
+
+std::uint64_t checked_mul(std::uint64_t lhs, std::uint64_t rhs)
 {
-	auto to_gear_idx = [row_len = line1.size()](std::size_t i, std::size_t j) -> int
+	if (lhs && rhs > std::numeric_limits<std::uint64_t>::max() / lhs)
 	{
-		return j * row_len + i + 1;
-	};
+		throw std::overflow_error("Gear ratio does not fit into 64 bits");
+	}
+	return lhs * rhs;
+}
 
-	std::array<int, max_adjacent_parts> result{};
-	std::size_t idx = 0;
-	if (number_start)
+std::uint64_t checked_add(std::uint64_t lhs, std::uint64_t rhs)
+{
+	if (rhs > std::numeric_limits<std::uint64_t>::max() - lhs)
 	{
-		if (line1[number_start - 1] == '*')
-		{
-			result[idx++] = to_gear_idx(cur_line - 1, number_start - 1);
-		}
-		if (line2[number_start - 1] == '*')
-		{
-			result[idx++] = to_gear_idx(cur_line, number_start - 1);
-		}
-		if (line3[number_start - 1] == '*')
-		{
-			result[idx++] = to_gear_idx(cur_line + 1, number_start - 1);
-		}
+		throw std::overflow_error("Sum of gear ratios does not fit into 64 bits");
 	}
-	for (std::size_t i = number_start; i <= number_end; ++i)
+	return lhs + rhs;
+}
+
+// Only the first two part numbers are kept; a third one disqualifies the gear.
+struct Gear
+{
+	unsigned parts = 0;
+	std::array<std::uint64_t, 2> numbers{};
+
+	void add_part(std::uint64_t number)
 	{
-		if (line1[i] == '*')
+		if (parts < 2)
 		{
-			result[idx++] = to_gear_idx(cur_line - 1, i);
+			numbers[parts] = number;
 		}
-		if (line3[i] == '*')
+		++parts;
+	}
+
+	// Combines partial views of the same gear collected by neighbouring bands.
+	void merge(const Gear & other)
+	{
+		const unsigned kept = std::min(other.parts, 2u);
+		for (unsigned i = 0; i < kept; ++i)
 		{
-			result[idx++] = to_gear_idx(cur_line + 1, i);
+			add_part(other.numbers[i]);
 		}
+		parts += other.parts - kept;
 	}
-	if (number_end != line1.size() - 1)
+
+	std::uint64_t ratio() const
+	{
+		return checked_mul(numbers[0], numbers[1]);
+	}
+};
+
+using GearRow = std::vector<Gear>;
+
+struct RowMasks
+{
+	day3::Mask digits;
+	day3::Mask stars;
+};
+
+void build_masks(std::string_view row, RowMasks & masks)
+{
+	const std::size_t words = (row.size() + 63) / 64;
+	masks.digits.assign(words, 0);
+	masks.stars.assign(words, 0);
+	for (std::size_t offset = 0; offset < row.size(); offset += 8)
 	{
-		if (line1[number_end + 1] == '*')
+		std::uint64_t chunk = day3::broadcast('.');
+		std::memcpy(&chunk, row.data() + offset, std::min<std::size_t>(8, row.size() - offset));
+		masks.digits[offset / 64] |= day3::gather(day3::digit_bytes(chunk)) << (offset % 64);
+		masks.stars[offset / 64] |= day3::gather(day3::equal_bytes(chunk, '*')) << (offset % 64);
+	}
+}
+
+void process_lines(
+	std::array<GearRow, 3> & gears,
+	const Window & window,
+	const std::array<RowMasks, 3> & masks,
+	std::string_view line,
+	day3::Mask & near_star)
+{
+	day3::dilate(near_star, masks[window.above].stars, masks[window.current].stars, masks[window.below].stars);
+
+	day3::for_each_number(
+		masks[window.current].digits,
+		[&](std::size_t first, std::size_t last)
 		{
-			result[idx++] = to_gear_idx(cur_line - 1, number_end + 1);
-		}
-		if (line2[number_end + 1] == '*')
+			if (!day3::any_bit(near_star, first, last))
+			{
+				return;
+			}
+			const std::uint64_t number = day3::parse_part_number(line.substr(first, last - first));
+			const std::size_t from = first ? first - 1 : first;
+			const std::size_t to = std::min(last + 1, line.size());
+			for (const std::size_t slot : {window.above, window.current, window.below})
+			{
+				day3::for_each_bit(
+					masks[slot].stars,
+					from,
+					to,
+					[&gears, slot, number](std::size_t column)
+					{
+						gears[slot][column].add_part(number);
+					});
+			}
+		});
+}
+
+// A gear on a band's edge rows can also touch numbers processed by the neighbouring band, so it is only resolved
+// after all bands are merged.
+struct EdgeGear
+{
+	std::size_t row = 0;
+	std::size_t column = 0;
+	Gear gear;
+};
+
+struct BandResult
+{
+	std::uint64_t ratios = 0;
+	std::vector<EdgeGear> edge_gears;
+};
+
+// Called when a row leaves the window: every number of the band that can touch its gears has been seen by then.
+void resolve_gears(BandResult & result, GearRow & row, std::size_t row_idx, bool is_edge)
+{
+	for (std::size_t column = 0; column < row.size(); ++column)
+	{
+		const Gear & gear = row[column];
+		if (is_edge && gear.parts)
 		{
-			result[idx++] = to_gear_idx(cur_line, number_end + 1);
+			result.edge_gears.push_back({row_idx, column, gear});
 		}
-		if (line3[number_end + 1] == '*')
+		else if (gear.parts == 2)
 		{
-			result[idx++] = to_gear_idx(cur_line + 1, number_end + 1);
+			result.ratios = checked_add(result.ratios, gear.ratio());
 		}
 	}
-	return result;
+	std::fill(row.begin(), row.end(), Gear{});
 }
 
-void save_part_number(std::unordered_map<int, std::array<int, 3>>::iterator it, unsigned number)
+// Streams the rows [first, last) through the three-row window. Gears on rows first - 1, first, last - 1 and last may
+// be shared with other bands and are reported as edge gears instead of being resolved.
+BandResult process_band(const day3::Schematic & schematic, std::size_t first, std::size_t last)
 {
-	auto & [key, value] = *it;
-	if (value[0] == -1)
+	std::array<GearRow, 3> gears;
+	for (auto & row : gears)
 	{
-		value[0] = number;
-		return;
+		row.assign(schematic.width(), Gear{});
 	}
-	if (value[1] == -1)
+	const auto is_edge = [first, last](std::size_t row)
 	{
-		value[1] = number;
-		return;
-	}
-	if (value[2] == -1)
+		return row <= first || row + 1 >= last;
+	};
+
+	BandResult result;
+	Window window;
+	std::array<RowMasks, 3> masks;
+	day3::Mask near_star;
+	build_masks(schematic.row(first - 1), masks[window.above]);
+	build_masks(schematic.row(first), masks[window.current]);
+	for (std::size_t i = first; i < last; ++i)
 	{
-		value[2] = number;
-		return;
+		build_masks(schematic.row(i + 1), masks[window.below]);
+		process_lines(gears, window, masks, schematic.row(i), near_star);
+		resolve_gears(result, gears[window.above], i - 1, is_edge(i - 1));
+		window.rotate();
 	}
+	resolve_gears(result, gears[window.above], last - 1, true);
+	resolve_gears(result, gears[window.current], last, true);
+	return result;
 }
 
-void process_lines(
-	std::unordered_map<int, std::array<int, 3>> & gear_ratios,
-	std::size_t cur_line,
-	std::string_view line1,
-	std::string_view line2,
-	std::string_view line3)
+std::uint64_t merge_edge_gears(std::vector<EdgeGear> & edge_gears)
 {
-	std::size_t i = 0;
-	std::array<int, 3> empty{-1, -1, -1};
-	while (true)
+	std::sort(
+		edge_gears.begin(),
+		edge_gears.end(),
+		[](const EdgeGear & lhs, const EdgeGear & rhs)
+		{
+			return std::tie(lhs.row, lhs.column) < std::tie(rhs.row, rhs.column);
+		});
+
+	std::uint64_t result = 0;
+	for (auto it = edge_gears.begin(); it != edge_gears.end();)
 	{
-		std::size_t number_start = line2.find_first_of("0123456789", i);
-		if (number_start == std::string_view::npos)
+		Gear gear = it->gear;
+		auto next = std::next(it);
+		for (; next != edge_gears.end() && next->row == it->row && next->column == it->column; ++next)
 		{
-			break;
+			gear.merge(next->gear);
 		}
-		i = number_start;
-		while (std::isdigit(line2[i]))
+		if (gear.parts == 2)
 		{
-			++i;
-		};
-		unsigned number = atoi(line2.substr(number_start, i - number_start).data());
-		const auto gear_indices = get_gear_idx(cur_line, line1, line2, line3, number_start, i - 1);
-		for (const auto gear_idx : gear_indices)
-		{
-			if (gear_idx)
-			{
-				auto [it, inserted] = gear_ratios.insert(std::pair(gear_idx, empty));
-				save_part_number(it, number);
-			}
+			result = checked_add(result, gear.ratio());
 		}
+		it = next;
 	}
+	return result;
 }
 
 } // namespace
 
 int task_3_2(std::string_view input_file)
 {
-	std::ifstream input(input_file.data());
-	std::string line1, line2, line3;
+	const aoc::MappedFile file(input_file.data());
+	const day3::Schematic schematic(file.view());
 
-	std::getline(input, line2);
-	line1 = std::string(line2.size(), '.');
-
-	std::size_t cur_line = 1;
-	std::unordered_map<int, std::array<int, 3>> gear_ratios;
-	while (!input.bad() && !input.eof())
-	{
-		std::getline(input, line3);
-		process_lines(gear_ratios, cur_line++, line1, line2, line3);
-		line1 = std::move(line2);
-		line2 = std::move(line3);
-	}
-	line3 = std::string(line2.size(), '.');
-	process_lines(gear_ratios, cur_line, line1, line2, line3);
+	auto bands = aoc::run_bands(
+		schematic.height(),
+		[&schematic](std::size_t first, std::size_t last)
+		{
+			return process_band(schematic, first, last);
+		});
 
-	unsigned result = 0;
-	for (const auto & [key, value] : gear_ratios)
+	std::uint64_t result = 0;
+	std::vector<EdgeGear> edge_gears;
+	for (auto & band : bands)
 	{
-		if (value[0] != -1 && value[1] != -1 && value[2] == -1)
-		{
-			result += value[0] * value[1];
-		}
+		result = checked_add(result, band.ratios);
+		edge_gears.insert(edge_gears.end(), band.edge_gears.begin(), band.edge_gears.end());
 	}
+	result = checked_add(result, merge_edge_gears(edge_gears));
 
 	std::cout << result << '\n';
 	return 0;
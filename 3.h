@@ -0,0 +1,208 @@
+#pragma once
+
+#include <algorithm>
+#include <bit>
+#include <charconv>
+#include <cstdint>
+#include <stdexcept>
+#include <string>
+#include <string_view>
+#include <system_error>
+#include <vector>
+
+// Engine schematic scanning shared by both parts of day 3.
+namespace day3
+{
+
+// All rows have the same width, so row `idx` starts at `idx * (width + 1)`. Rows outside the schematic (including
+// `idx - 1` wrapping around above the first row) read as padding. The layout is checked up front, since a ragged row
+// would otherwise silently shift every row after it.
+class Schematic
+{
+public:
+	explicit Schematic(std::string_view text)
+		: text_(text)
+		, width_(std::min(text.find('\n'), text.size()))
+		, height_(width_ ? (text.size() + 1) / (width_ + 1) : 0)
+		, padding_(width_, '.')
+	{
+		if (!width_)
+		{
+			if (!text_.empty())
+			{
+				throw std::invalid_argument("Schematic starts with an empty row");
+			}
+			return;
+		}
+		if (text_[width_ - 1] == '\r')
+		{
+			throw std::invalid_argument("Schematic rows end in CR");
+		}
+		const std::size_t stride = width_ + 1;
+		for (std::size_t idx = 0; idx + 1 < height_; ++idx)
+		{
+			if (text_[idx * stride + width_] != '\n')
+			{
+				throw std::invalid_argument("Ragged schematic row " + std::to_string(idx + 1));
+			}
+		}
+		// The last row may or may not be followed by a newline.
+		const bool terminated = text_.size() == height_ * stride && text_.back() == '\n';
+		if (!terminated && text_.size() + 1 != height_ * stride)
+		{
+			throw std::invalid_argument("Ragged schematic row " + std::to_string(height_));
+		}
+		const std::size_t newlines = terminated ? height_ : height_ - 1;
+		if (static_cast<std::size_t>(std::count(text_.begin(), text_.end(), '\n')) != newlines)
+		{
+			throw std::invalid_argument("Schematic row contains a newline");
+		}
+	}
+
+	std::size_t width() const
+	{
+		return width_;
+	}
+
+	std::size_t height() const
+	{
+		return height_;
+	}
+
+	std::string_view row(std::size_t idx) const
+	{
+		if (idx >= height_)
+		{
+			return padding_;
+		}
+		return text_.substr(idx * (width_ + 1), width_);
+	}
+
+private:
+	std::string_view text_;
+	std::size_t width_;
+	std::size_t height_;
+	std::string padding_;
+};
+
+// Rows are classified eight bytes at a time: each helper sets the high bit of every matching byte, and `gather`
+// packs those high bits into one bit per column. Column i of a row maps to bit i % 64 of word i / 64.
+static_assert(std::endian::native == std::endian::little);
+
+constexpr std::uint64_t broadcast(unsigned char ch)
+{
+	return 0x0101010101010101ull * ch;
+}
+
+constexpr std::uint64_t low_bits = broadcast(0x7F);
+constexpr std::uint64_t high_bits = broadcast(0x80);
+
+inline std::uint64_t equal_bytes(std::uint64_t chunk, char ch)
+{
+	const std::uint64_t x = chunk ^ broadcast(ch);
+	return ~(((x & low_bits) + low_bits) | x | low_bits);
+}
+
+inline std::uint64_t digit_bytes(std::uint64_t chunk)
+{
+	const std::uint64_t low = chunk & low_bits;
+	return (low + broadcast(0x80 - '0')) & ~(low + broadcast(0x80 - '9' - 1)) & ~chunk & high_bits;
+}
+
+inline std::uint64_t gather(std::uint64_t bytes)
+{
+	return ((bytes & high_bits) >> 7) * 0x0102040810204080ull >> 56;
+}
+
+using Mask = std::vector<std::uint64_t>;
+
+// Bits of `mask` in columns [first, last).
+inline std::uint64_t range_bits(const Mask & mask, std::size_t word, std::size_t first, std::size_t last)
+{
+	const std::size_t lo = std::max(first, word * 64) - word * 64;
+	const std::size_t hi = std::min(last, word * 64 + 64) - word * 64;
+	const std::uint64_t below_hi = hi == 64 ? ~std::uint64_t(0) : (std::uint64_t(1) << hi) - 1;
+	return mask[word] & below_hi & ~((std::uint64_t(1) << lo) - 1);
+}
+
+inline bool any_bit(const Mask & mask, std::size_t first, std::size_t last)
+{
+	for (std::size_t word = first / 64; word * 64 < last; ++word)
+	{
+		if (range_bits(mask, word, first, last))
+		{
+			return true;
+		}
+	}
+	return false;
+}
+
+// Calls `f(column)` for every set bit of `mask` in columns [first, last).
+template <typename F>
+void for_each_bit(const Mask & mask, std::size_t first, std::size_t last, F && f)
+{
+	for (std::size_t word = first / 64; word * 64 < last; ++word)
+	{
+		for (std::uint64_t bits = range_bits(mask, word, first, last); bits; bits &= bits - 1)
+		{
+			f(word * 64 + std::countr_zero(bits));
+		}
+	}
+}
+
+// Marks every column that is next to (or on) a set column of any of the three rows.
+inline void dilate(Mask & result, const Mask & row1, const Mask & row2, const Mask & row3)
+{
+	const std::size_t words = row2.size();
+	result.resize(words);
+	std::uint64_t prev = 0;
+	std::uint64_t cur = words ? row1[0] | row2[0] | row3[0] : 0;
+	for (std::size_t word = 0; word < words; ++word)
+	{
+		const std::uint64_t next = word + 1 < words ? row1[word + 1] | row2[word + 1] | row3[word + 1] : 0;
+		result[word] = cur | (cur << 1) | (cur >> 1) | (prev >> 63) | (next << 63);
+		prev = cur;
+		cur = next;
+	}
+}
+
+// Calls `f(first, last)` for every run of digits, i.e. every number of the row.
+template <typename F>
+void for_each_number(const Mask & digits, F && f)
+{
+	const std::size_t words = digits.size();
+	for (std::size_t word = 0; word < words; ++word)
+	{
+		const std::uint64_t carry = word ? digits[word - 1] >> 63 : 0;
+		std::uint64_t starts = digits[word] & ~((digits[word] << 1) | carry);
+		while (starts)
+		{
+			const std::size_t first = word * 64 + std::countr_zero(starts);
+			starts &= starts - 1;
+
+			std::size_t last = first + std::countr_one(digits[word] >> (first % 64));
+			while (last % 64 == 0 && last / 64 < words)
+			{
+				const int ones = std::countr_one(digits[last / 64]);
+				last += ones;
+				if (ones < 64)
+				{
+					break;
+				}
+			}
+			f(first, last);
+		}
+	}
+}
+
+inline std::uint64_t parse_part_number(std::string_view digits)
+{
+	std::uint64_t number = 0;
+	if (std::from_chars(digits.data(), digits.data() + digits.size(), number).ec != std::errc())
+	{
+		throw std::out_of_range("Part number does not fit into 64 bits");
+	}
+	return number;
+}
+
+} // namespace day3
@@ -1,61 +1,22 @@
+#include "4.h"
 #include "h.h"
 
+#include <cstdint>
 #include <fstream>
-#include <functional>
 #include <iostream>
-#include <ranges>
-#include <unordered_set>
+#include <stdexcept>
 
 namespace
 {
 
-void on_numbers(std::string_view line, [[maybe_unused]] const std::function<void(unsigned)> & f)
+std::uint64_t process_line(std::string_view line)
 {
-	for (std::size_t i = 0; i < line.size() / 3; ++i)
+	const std::size_t matches = day4::card_matches(line);
+	if (matches > 64)
 	{
-		unsigned number = 0;
-		if (line[3*i + 1] != ' ')
-		{
-			number += 10 * (line[3*i + 1] - '0');
-		}
-		number += (line[3*i + 2] - '0');
-		f(number);
+		throw std::overflow_error("Card score does not fit into 64 bits");
 	}
-}
-
-unsigned process_line(std::string_view line)
-{
-	line = line.substr(line.find_first_of(':') + 1);
-	std::size_t pipe_pos = line.find_first_of('|');
-	std::string_view win = line.substr(0, pipe_pos - 1);
-	std::string_view my = line.substr(pipe_pos + 1);
-
-	std::unordered_set<unsigned> win_numbers;
-	on_numbers(
-		win,
-		[&win_numbers](unsigned number)
-		{
-			win_numbers.insert(number);
-		});
-
-	unsigned result = 0;
-	on_numbers(
-		my,
-		[&win_numbers, &result](unsigned number)
-		{
-			if (win_numbers.contains(number))
-			{
-				if (!result)
-				{
-					result = 1;
-				}
-				else
-				{
-					result *= 2;
-				}
-			}
-		});
-	return result;
+	return matches ? std::uint64_t(1) << (matches - 1) : 0;
 }
 
 } // namespace
@@ -65,11 +26,11 @@ int task_4_1(std::string_view input_file)
 	std::ifstream input(input_file.data());
 
 	std::string line;
-	unsigned result = 0;
+	std::uint64_t result = 0;
 	while (!input.bad() && !input.eof())
 	{
 		std::getline(input, line);
-		result += process_line(line);
+		result = day4::checked_add(result, process_line(line));
 	}
 	std::cout << result << '\n';
 
@@ -1,54 +1,62 @@
+#include "4.h"
+#include "common.h"
 #include "h.h"
 
-#include <deque>
-#include <fstream>
-#include <functional>
+#include <algorithm>
+#include <array>
+#include <cstdint>
 #include <iostream>
-#include <ranges>
-#include <unordered_set>
+#include <vector>
 
 namespace
 {
 
-void on_numbers(std::string_view line, [[maybe_unused]] const std::function<void(unsigned)> & f)
+// Copies of a card are added to the next `matches` cards at once: they join a running total and are scheduled to
+// leave it right after the last won card. A card never wins more cards than a NumberSet holds, so the schedule is a
+// small ring instead of a per-card array, and every card costs O(1).
+class CardCopies
 {
-	for (std::size_t i = 0; i < line.size() / 3; ++i)
+public:
+	// Returns the number of copies of the next card and records the cards they win.
+	std::uint64_t next(std::size_t matches)
 	{
-		unsigned number = 0;
-		if (line[3 * i + 1] != ' ')
+		running_ -= expiring_[pos_];
+		expiring_[pos_] = 0;
+
+		const std::uint64_t copies = day4::checked_add(running_, 1);
+		if (matches)
 		{
-			number += 10 * (line[3 * i + 1] - '0');
+			running_ = day4::checked_add(running_, copies);
+			expiring_[(pos_ + matches + 1) % ring_size] += copies;
 		}
-		number += (line[3 * i + 2] - '0');
-		f(number);
+		pos_ = (pos_ + 1) % ring_size;
+		return copies;
 	}
-}
 
-unsigned process_line(std::string_view line)
-{
-	line = line.substr(line.find_first_of(':') + 1);
-	std::size_t pipe_pos = line.find_first_of('|');
-	std::string_view win = line.substr(0, pipe_pos - 1);
-	std::string_view my = line.substr(pipe_pos + 1);
+private:
+	static constexpr std::size_t ring_size = 256;
+	static_assert(ring_size > day4::NumberSet().size() + 1);
 
-	std::unordered_set<unsigned> win_numbers;
-	on_numbers(
-		win,
-		[&win_numbers](unsigned number)
-		{
-			win_numbers.insert(number);
-		});
+	std::array<std::uint64_t, ring_size> expiring_{};
+	std::uint64_t running_ = 0;
+	std::size_t pos_ = 0;
+};
 
-	unsigned result = 0;
-	on_numbers(
-		my,
-		[&win_numbers, &result](unsigned number)
+// Phase one: match counts of all cards whose lines start in [first, last), in input order.
+std::vector<std::uint8_t> count_matches(std::string_view text, std::size_t first, std::size_t last)
+{
+	std::vector<std::uint8_t> result;
+	const std::size_t end = aoc::line_start(text, last);
+	for (std::size_t pos = aoc::line_start(text, first); pos < end;)
+	{
+		const std::size_t eol = std::min(text.find('\n', pos), text.size());
+		const std::string_view line = text.substr(pos, eol - pos);
+		if (!line.empty())
 		{
-			if (win_numbers.contains(number))
-			{
-				result += 1;
-			}
-		});
+			result.push_back(static_cast<std::uint8_t>(day4::card_matches(line)));
+		}
+		pos = eol + 1;
+	}
 	return result;
 }
 
@@ -56,30 +64,24 @@ unsigned process_line(std::string_view line)
 
 int task_4_2(std::string_view input_file)
 {
-	std::ifstream input(input_file.data());
-
-	std::string line;
-	unsigned result = 0;
-	std::deque<unsigned> multipliers;
-	while (!input.bad() && !input.eof())
-	{
-		std::getline(input, line);
-		++result;
+	const aoc::MappedFile file(input_file.data());
+	const std::string_view text = file.view();
 
-		const auto won_cards = process_line(line);
-		const auto multiplier = multipliers.empty() ? 1 : multipliers.front();
-		const auto won = won_cards * multiplier;
-		result += won;
-		if (!multipliers.empty())
+	const auto bands = aoc::run_bands(
+		text.size(),
+		[text](std::size_t first, std::size_t last)
 		{
-			multipliers.pop_front();
-		}
+			return count_matches(text, first, last);
+		});
 
-		const std::size_t size = std::max(std::size_t(won_cards), multipliers.size());
-		multipliers.resize(size, 1);
-		for (std::size_t i = 0; i < won_cards; ++i)
+	// Phase two: copies only flow forward, so propagation is a single cheap pass over the match counts.
+	std::uint64_t result = 0;
+	CardCopies copies;
+	for (const auto & band : bands)
+	{
+		for (const std::uint8_t matches : band)
 		{
-			multipliers[i] += multiplier;
+			result = day4::checked_add(result, copies.next(matches));
 		}
 	}
 	std::cout << result << '\n';
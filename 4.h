@@ -0,0 +1,47 @@
+#pragma once
+
+#include <bitset>
+#include <cstdint>
+#include <limits>
+#include <stdexcept>
+#include <string_view>
+
+// Scratchcard scoring shared by both parts of day 4.
+namespace day4
+{
+
+// Every number is below 100, so a card side fits into a fixed-width set and a card is scored with AND and popcount.
+using NumberSet = std::bitset<128>;
+
+// Numbers occupy fixed three-character columns (" dd" or "  d"). A blank tens digit decodes as zero since
+// ' ' & 0xF == 0, so each column is decoded without branches.
+inline NumberSet to_number_set(std::string_view line)
+{
+	NumberSet result;
+	for (std::size_t i = 0; i < line.size() / 3; ++i)
+	{
+		result[(line[3 * i + 1] & 0x0F) * 10 + (line[3 * i + 2] & 0x0F)] = true;
+	}
+	return result;
+}
+
+// Number of winning numbers on the card.
+inline std::size_t card_matches(std::string_view line)
+{
+	line = line.substr(line.find_first_of(':') + 1);
+	std::size_t pipe_pos = line.find_first_of('|');
+	const NumberSet win = to_number_set(line.substr(0, pipe_pos - 1));
+	const NumberSet my = to_number_set(line.substr(pipe_pos + 1));
+	return (win & my).count();
+}
+
+inline std::uint64_t checked_add(std::uint64_t lhs, std::uint64_t rhs)
+{
+	if (rhs > std::numeric_limits<std::uint64_t>::max() - lhs)
+	{
+		throw std::overflow_error("Card total does not fit into 64 bits");
+	}
+	return lhs + rhs;
+}
+
+} // namespace day4
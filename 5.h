@@ -0,0 +1,295 @@
+#pragma once
+
+#include <algorithm>
+#include <charconv>
+#include <cstdint>
+#include <istream>
+#include <limits>
+#include <stdexcept>
+#include <string>
+#include <string_view>
+#include <unordered_map>
+#include <utility>
+#include <vector>
+
+// Almanac maps shared by both parts of day 5.
+namespace day5
+{
+
+inline std::uint64_t checked_end(std::uint64_t start, std::uint64_t len)
+{
+	if (len > std::numeric_limits<std::uint64_t>::max() - start)
+	{
+		throw std::overflow_error("Range end does not fit into 64 bits");
+	}
+	return start + len;
+}
+
+inline std::vector<std::uint64_t> parse_numbers(std::string_view str)
+{
+	std::vector<std::uint64_t> result;
+	const char * it = str.data();
+	const char * const end = str.data() + str.size();
+	while (true)
+	{
+		while (it != end && *it == ' ')
+		{
+			++it;
+		}
+		if (it == end)
+		{
+			break;
+		}
+		std::uint64_t number = 0;
+		const auto [ptr, ec] = std::from_chars(it, end, number);
+		if (ec != std::errc())
+		{
+			throw std::invalid_argument("Bad number in \"" + std::string(str) + '"');
+		}
+		result.push_back(number);
+		it = ptr;
+	}
+	return result;
+}
+
+// Ranges are half-open: [begin, end).
+struct Interval
+{
+	std::uint64_t begin = 0;
+	std::uint64_t end = 0;
+
+	std::uint64_t size() const
+	{
+		return end - begin;
+	}
+};
+
+struct MappingPart
+{
+	std::uint64_t dst_start;
+	std::uint64_t src_start;
+	std::uint64_t len;
+
+	Interval src() const
+	{
+		return {src_start, src_start + len};
+	}
+};
+
+inline MappingPart to_mapping_part(std::string_view str)
+{
+	const auto numbers = parse_numbers(str);
+	if (numbers.size() != 3)
+	{
+		throw std::logic_error("Bad mapping part \"" + std::string(str) + '"');
+	}
+	const MappingPart result{numbers[0], numbers[1], numbers[2]};
+	checked_end(result.dst_start, result.len);
+	checked_end(result.src_start, result.len);
+	return result;
+}
+
+// A piecewise translation over sorted breakpoints: piece i covers [starts_[i], starts_[i + 1]) (the last piece is
+// unbounded) and shifts values by offsets_[i]. Gaps between mapping parts are pieces with a zero offset, so a lookup
+// is a single binary search and mappings compose into another PiecewiseMap.
+class PiecewiseMap
+{
+public:
+	// The identity map.
+	PiecewiseMap()
+		: starts_{0}
+		, offsets_{0}
+	{
+	}
+
+	explicit PiecewiseMap(std::vector<MappingPart> parts)
+		: PiecewiseMap()
+	{
+		std::sort(
+			parts.begin(),
+			parts.end(),
+			[](const MappingPart & lhs, const MappingPart & rhs)
+			{
+				return lhs.src_start < rhs.src_start;
+			});
+
+		for (const MappingPart & part : parts)
+		{
+			const Interval src = part.src();
+			if (!src.size())
+			{
+				continue;
+			}
+			if (src.begin < starts_.back())
+			{
+				throw std::logic_error("Overlapping mapping parts");
+			}
+			if (src.begin != starts_.back())
+			{
+				starts_.push_back(src.begin);
+				offsets_.push_back(0);
+			}
+			offsets_.back() = part.dst_start - part.src_start;
+			starts_.push_back(src.end);
+			offsets_.push_back(0);
+		}
+	}
+
+	std::uint64_t map(std::uint64_t src) const
+	{
+		return src + offsets_[find(src)];
+	}
+
+	// Appends the images of the pieces `src` is split into.
+	void map(Interval src, std::vector<Interval> & result) const
+	{
+		for (std::size_t i = find(src.begin); src.begin < src.end; ++i)
+		{
+			const std::uint64_t end = i + 1 < starts_.size() ? std::min(src.end, starts_[i + 1]) : src.end;
+			result.push_back({src.begin + offsets_[i], end + offsets_[i]});
+			src.begin = end;
+		}
+	}
+
+	// The map that applies `*this` first and `next` second. Every piece of `*this` is cut where its image crosses a
+	// breakpoint of `next`; neighbouring pieces that end up with the same offset are merged.
+	PiecewiseMap then(const PiecewiseMap & next) const
+	{
+		PiecewiseMap result;
+		result.starts_.clear();
+		result.offsets_.clear();
+		for (std::size_t i = 0; i < starts_.size(); ++i)
+		{
+			const std::uint64_t offset = offsets_[i];
+			const bool bounded = i + 1 < starts_.size();
+			const std::uint64_t image_end = bounded ? starts_[i + 1] + offset : 0;
+			std::uint64_t start = starts_[i];
+			for (std::size_t j = next.find(start + offset);; ++j)
+			{
+				result.append(start, offset + next.offsets_[j]);
+				if (j + 1 == next.starts_.size() || (bounded && next.starts_[j + 1] >= image_end))
+				{
+					break;
+				}
+				start = next.starts_[j + 1] - offset;
+			}
+		}
+		return result;
+	}
+
+	std::size_t pieces() const
+	{
+		return starts_.size();
+	}
+
+private:
+	std::size_t find(std::uint64_t value) const
+	{
+		const auto it = std::upper_bound(starts_.begin(), starts_.end(), value);
+		return std::distance(starts_.begin(), it) - 1;
+	}
+
+	void append(std::uint64_t start, std::uint64_t offset)
+	{
+		if (!offsets_.empty() && offsets_.back() == offset)
+		{
+			return;
+		}
+		starts_.push_back(start);
+		offsets_.push_back(offset);
+	}
+
+private:
+	std::vector<std::uint64_t> starts_;
+	std::vector<std::uint64_t> offsets_;
+};
+
+class Mapping
+{
+public:
+	Mapping(std::string from, std::string to, std::vector<MappingPart> parts)
+		: from_(std::move(from))
+		, to_(std::move(to))
+		, map_(std::move(parts))
+	{
+	}
+
+	std::string_view from() const &
+	{
+		return from_;
+	}
+
+	std::string_view to() const
+	{
+		return to_;
+	}
+
+	const PiecewiseMap & map() const
+	{
+		return map_;
+	}
+
+private:
+	std::string from_;
+	std::string to_;
+	PiecewiseMap map_;
+};
+
+inline std::pair<std::string_view, std::string_view> parse_from_to(std::string_view str)
+{
+	std::size_t from_end = str.find_first_of('-');
+	std::string_view from = str.substr(0, from_end);
+	str = str.substr(from_end + std::string_view("-to-").size());
+	std::string_view to = str.substr(0, str.find_first_of(' '));
+	return {from, to};
+}
+
+inline Mapping process_mappings(std::istream & input)
+{
+	std::string line;
+	std::getline(input, line);
+	const auto [from, to] = std::pair<std::string, std::string>(parse_from_to(line));
+	std::vector<MappingPart> parts;
+	do
+	{
+		std::getline(input, line);
+		if (line.empty())
+		{
+			break;
+		}
+		parts.push_back(to_mapping_part(line));
+	}
+	while (true);
+	return {from, to, parts};
+}
+
+// Composes the stages from "seed" to "location", looking every stage up by name once. `on_stage(to, map)` sees the
+// composed map after each stage.
+template <typename F>
+PiecewiseMap seed_to_location(const std::vector<Mapping> & mappings, F && on_stage)
+{
+	std::unordered_map<std::string_view, const Mapping *> by_source;
+	for (const auto & mapping : mappings)
+	{
+		by_source.insert({mapping.from(), &mapping});
+	}
+
+	PiecewiseMap result;
+	std::string_view from = "seed";
+	while (from != "location")
+	{
+		const auto it = by_source.find(from);
+		if (it == by_source.end())
+		{
+			throw std::logic_error("No mapping from " + std::string(from));
+		}
+		const Mapping & mapping = *it->second;
+		by_source.erase(it);
+		result = result.then(mapping.map());
+		from = mapping.to();
+		on_stage(from, result);
+	}
+	return result;
+}
+
+} // namespace day5
@@ -1,92 +1,193 @@
+#include "6.h"
 #include "h.h"
 
-#include <cmath>
+#include <algorithm>
+#include <array>
+#include <cstdint>
 #include <fstream>
 #include <iostream>
+#include <limits>
+#include <new>
+#include <stdexcept>
 #include <vector>
 
+#if defined(__SSE2__)
+#include <emmintrin.h>
+#endif
+
 namespace
 {
 
 using namespace std::string_view_literals;
 
-struct Race
+// Columns start on a cache line, so every block of lanes in calc_all() can be loaded with aligned vector loads.
+template <typename T>
+struct AlignedAllocator
 {
-	unsigned time = 0;
-	unsigned distance = 0;
+	using value_type = T;
+	static constexpr std::align_val_t alignment{64};
+
+	AlignedAllocator() = default;
+
+	template <typename U>
+	AlignedAllocator(const AlignedAllocator<U> &)
+	{}
+
+	T * allocate(std::size_t n)
+	{
+		return static_cast<T *>(::operator new(n * sizeof(T), alignment));
+	}
+
+	void deallocate(T * p, std::size_t)
+	{
+		::operator delete(p, alignment);
+	}
+
+	template <typename U>
+	bool operator==(const AlignedAllocator<U> &) const
+	{
+		return true;
+	}
 };
 
+using Column = std::vector<std::uint64_t, AlignedAllocator<std::uint64_t>>;
+
 struct Races
 {
-	std::vector<unsigned> times;
-	std::vector<unsigned> distances;
+	Column times;
+	Column distances;
 
 	std::size_t size() const
 	{
 		return times.size();
 	}
 
-	Race operator[](std::size_t idx) const
+	day6::Race operator[](std::size_t idx) const
 	{
-		return Race{times[idx], distances[idx]};
+		return day6::Race{times[idx], distances[idx]};
 	}
 };
 
-std::vector<unsigned> parse_data(std::string_view line)
+// Appends the numbers after the colon straight to `column`.
+void parse_data(std::string_view line, Column & column)
 {
-	std::vector<unsigned> result;
-	line = line.substr(line.find_first_of(':') + 1);
+	const char * it = line.data() + line.find_first_of(':') + 1;
+	const char * const end = line.data() + line.size();
 	while (true)
 	{
-		while (line[0] == ' ')
+		while (it != end && *it == ' ')
 		{
-			line = line.substr(1);
+			++it;
 		}
-		auto number_end = line.find_first_of(' ');
-		unsigned number = atoi(line.substr(0, number_end).data());
-		result.push_back(number);
-		if (number_end == std::string_view::npos)
+		if (it == end)
 		{
 			break;
 		}
-		line = line.substr(number_end);
+		const char * const number_end = std::find(it, end, ' ');
+		column.push_back(day6::parse_value(std::string_view(it, number_end)));
+		it = number_end;
 	}
-	return result;
 }
 
-unsigned calc_one(Race race)
+constexpr std::size_t lanes = 8;
+
+#if defined(__SSE2__)
+// Below these bounds T^2 - 4D - 1 is exact in doubles, and its root fits into 32 bits.
+constexpr std::uint64_t max_fast_time = std::uint64_t(1) << 26;
+constexpr std::uint64_t max_fast_distance = std::uint64_t(1) << 50;
+
+// Converts two values below 2^52 to doubles: placed into the mantissa of 2^52 they give exactly 2^52 + value.
+__m128d to_double(__m128i values)
+{
+	const __m128d magic = _mm_set1_pd(0x1p52);
+	return _mm_sub_pd(_mm_or_pd(_mm_castsi128_pd(values), magic), magic);
+}
+
+bool fits_fast_path(const std::uint64_t * times, const std::uint64_t * distances)
 {
-	//  ^ D
-	//  |             /
-	//  |            /
-	//  |           /
-	//  |          /
-	//  |         /
-	//  |________/
-	//  +--------|-----|---> T
-	//      t1     t2
-	//
-	// y = k * x
-	// D = t1 * t2
-	// T = t1 + t2
-	// t2 = T - t1
-	// D = t1 * (T - T1)
-	// t1^2 - T * t1 + D = 0
-	// t1_1 = (T - sqrt(T^2 - 4 * D)) / 2
-	// t1_2 = (T + sqrt(T^2 - 4 * D)) / 2
-	unsigned t1 = ceil(0.5 * (race.time - sqrt(race.time * race.time - 4 * race.distance)));
-	unsigned t2 = trunc(0.5 * (race.time + sqrt(race.time * race.time - 4 * race.distance)));
-	unsigned t1_distance = t1 * (race.time - t1);
-	unsigned t2_distance = t2 * (race.time - t2);
-	if (t1_distance == race.distance)
+	bool fits = true;
+	for (std::size_t lane = 0; lane < lanes; ++lane)
 	{
-		++t1;
+		fits &= times[lane] <= max_fast_time && distances[lane] < max_fast_distance;
 	}
-	if (t2_distance == race.distance)
+	return fits;
+}
+
+// Solves a full, aligned block with packed square roots, two lanes per register. The rounded roots are made exact
+// by correct_root(), which only multiplies.
+void calc_block(const std::uint64_t * times, const std::uint64_t * distances, std::uint64_t * result)
+{
+	alignas(16) std::array<double, lanes> roots;
+	const __m128d one = _mm_set1_pd(1.0);
+	const __m128d four = _mm_set1_pd(4.0);
+	for (std::size_t lane = 0; lane < lanes; lane += 2)
 	{
-		--t2;
+		const __m128d time = to_double(_mm_load_si128(reinterpret_cast<const __m128i *>(times + lane)));
+		const __m128d distance = to_double(_mm_load_si128(reinterpret_cast<const __m128i *>(distances + lane)));
+		const __m128d radicand = _mm_sub_pd(_mm_mul_pd(time, time), _mm_add_pd(_mm_mul_pd(four, distance), one));
+		_mm_store_pd(roots.data() + lane, _mm_sqrt_pd(_mm_max_pd(radicand, _mm_setzero_pd())));
 	}
-	return t2 - t1 + 1;
+	for (std::size_t lane = 0; lane < lanes; ++lane)
+	{
+		const std::uint64_t square = times[lane] * times[lane];
+		const std::uint64_t bound = 4 * distances[lane];
+		if (square <= bound)
+		{
+			result[lane] = 0;
+			continue;
+		}
+		const std::uint64_t root = day6::correct_root(square - bound - 1, static_cast<std::uint64_t>(roots[lane]));
+		result[lane] = day6::ways_from_root(day6::Race{times[lane], distances[lane]}, root);
+	}
+}
+#endif
+
+// Races are solved in blocks of `lanes`. Where SSE2 is available, blocks whose values are small enough take the
+// packed path in calc_block(); the rest, and the tail, go through the scalar ways_to_win().
+void calc_all(const Races & races, std::vector<std::uint64_t> & result)
+{
+	const std::size_t size = races.size();
+	const std::uint64_t * const times = races.times.data();
+	const std::uint64_t * const distances = races.distances.data();
+	result.resize(size);
+	std::size_t i = 0;
+#if defined(__SSE2__)
+	for (; i + lanes <= size; i += lanes)
+	{
+		if (fits_fast_path(times + i, distances + i))
+		{
+			calc_block(times + i, distances + i, result.data() + i);
+			continue;
+		}
+		for (std::size_t lane = 0; lane < lanes; ++lane)
+		{
+			result[i + lane] = day6::ways_to_win(races[i + lane]);
+		}
+	}
+#endif
+	for (; i < size; ++i)
+	{
+		result[i] = day6::ways_to_win(races[i]);
+	}
+}
+
+// A race that cannot be won makes the product zero however large the other factors are.
+std::uint64_t checked_product(const std::vector<std::uint64_t> & values)
+{
+	if (std::find(values.begin(), values.end(), 0) != values.end())
+	{
+		return 0;
+	}
+	std::uint64_t result = 1;
+	for (const std::uint64_t value : values)
+	{
+		if (result > std::numeric_limits<std::uint64_t>::max() / value)
+		{
+			throw std::overflow_error("Product of race counts does not fit into 64 bits");
+		}
+		result *= value;
+	}
+	return result;
 }
 
 } // namespace
@@ -99,12 +200,16 @@ int task_6_1(std::string_view input_file)
 	std::getline(input, times);
 	std::string distances;
 	std::getline(input, distances);
-	Races races{parse_data(times), parse_data(distances)};
-	unsigned result = 1;
-	for (std::size_t i = 0; i < races.size(); ++i)
+	Races races;
+	parse_data(times, races.times);
+	parse_data(distances, races.distances);
+	if (races.times.size() != races.distances.size())
 	{
-		result *= calc_one(races[i]);
+		throw std::logic_error("Times and distances differ in length");
 	}
+	std::vector<std::uint64_t> ways;
+	calc_all(races, ways);
+	const std::uint64_t result = checked_product(ways);
 	std::cout << result << '\n';
 
 	return 0;
@@ -0,0 +1,106 @@
+#pragma once
+
+#include <algorithm>
+#include <charconv>
+#include <cmath>
+#include <cstdint>
+#include <limits>
+#include <stdexcept>
+#include <string>
+#include <string_view>
+#include <system_error>
+
+// Race arithmetic shared by both parts of day 6.
+namespace day6
+{
+
+using uint128 = unsigned __int128;
+
+// Largest time or distance ways_to_win() is exact for.
+constexpr std::uint64_t max_value = std::numeric_limits<std::int64_t>::max();
+
+// Parses a time or distance, which must be all digits and at most max_value.
+inline std::uint64_t parse_value(std::string_view digits)
+{
+	std::uint64_t value = 0;
+	const char * const end = digits.data() + digits.size();
+	const auto [ptr, ec] = std::from_chars(digits.data(), end, value);
+	if (ec == std::errc::result_out_of_range || (ec == std::errc() && value > max_value))
+	{
+		throw std::out_of_range("Race value " + std::string(digits) + " does not fit into 63 bits");
+	}
+	if (ec != std::errc() || ptr != end)
+	{
+		throw std::invalid_argument("Bad number \"" + std::string(digits) + '"');
+	}
+	return value;
+}
+
+struct Race
+{
+	std::uint64_t time = 0;
+	std::uint64_t distance = 0;
+};
+
+// Moves `r`, an estimate of floor(sqrt(n)) that is off by at most a few units, onto the exact root. Only 128-bit
+// products are involved; the root must be below 2^64 - 1 so that r + 1 cannot wrap.
+inline std::uint64_t correct_root(uint128 n, std::uint64_t r)
+{
+	while (uint128(r) * r > n)
+	{
+		--r;
+	}
+	while (uint128(r + 1) * (r + 1) <= n)
+	{
+		++r;
+	}
+	return r;
+}
+
+static_assert(std::numeric_limits<long double>::digits >= 64);
+
+// floor(sqrt(n)) for n below 2^126. Both rounding n to a 64-bit mantissa and the square root itself are relatively
+// off by at most 2^-64, so for a root below 2^63 the long double estimate is within one of it.
+inline std::uint64_t isqrt(uint128 n)
+{
+	return correct_root(n, static_cast<std::uint64_t>(std::sqrt(static_cast<long double>(n))));
+}
+
+// Number of winning hold times of a race that can be won, given s = floor(sqrt(T^2 - 4D - 1)).
+inline std::uint64_t ways_from_root(Race race, std::uint64_t s)
+{
+	return (s - race.time) % 2 ? s : s + 1;
+}
+
+inline std::uint64_t ways_to_win(Race race)
+{
+	//  ^ D
+	//  |             /
+	//  |            /
+	//  |           /
+	//  |          /
+	//  |         /
+	//  |________/
+	//  +--------|-----|---> T
+	//      t1     t2
+	//
+	// y = k * x
+	// D = t1 * t2
+	// T = t1 + t2
+	// t2 = T - t1
+	// D = t1 * (T - T1)
+	// t1^2 - T * t1 + D = 0
+	//
+	// A hold time t wins when t * (T - t) > D, i.e. (2t - T)^2 < T^2 - 4D. With k = 2t - T that is |k| <= s, where
+	// s is the largest integer with s^2 < T^2 - 4D, and k has the parity of T. Everything is exact in 128 bits for
+	// T and D below 2^63.
+	const uint128 T = race.time;
+	const uint128 D = race.distance;
+	if (T * T <= 4 * D)
+	{
+		return 0;
+	}
+	return ways_from_root(race, isqrt(T * T - 4 * D - 1));
+}
+
+} // namespace day6
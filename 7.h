@@ -0,0 +1,497 @@
+#pragma once
+
+#include "common.h"
+
+#include <algorithm>
+#include <array>
+#include <charconv>
+#include <cstdint>
+#include <fstream>
+#include <iostream>
+#include <numeric>
+#include <stdexcept>
+#include <string>
+#include <string_view>
+#include <utility>
+#include <vector>
+
+// Camel Cards engine shared by both parts of day 7; the part-specific rules are a template parameter.
+namespace day7
+{
+
+struct StandardRules
+{
+	static constexpr std::string_view all_cards = "23456789TJQKA";
+	static constexpr bool jokers = false;
+};
+
+struct JokerRules
+{
+	static constexpr std::string_view all_cards = "J23456789TQKA";
+	static constexpr bool jokers = true;
+};
+
+enum class CardScore : unsigned
+{
+};
+
+namespace detail
+{
+
+template <typename Rules>
+constexpr std::array<CardScore, 256> make_card_scores()
+{
+	std::array<CardScore, 256> result{};
+	for (std::size_t i = 0; i < Rules::all_cards.size(); ++i)
+	{
+		result[static_cast<unsigned char>(Rules::all_cards[i])] = static_cast<CardScore>(i + 1);
+	}
+	return result;
+}
+
+// Score of every byte value, zero for bytes that are not cards.
+template <typename Rules>
+constexpr std::array<CardScore, 256> card_scores = make_card_scores<Rules>();
+
+} // namespace detail
+
+template <typename Rules>
+constexpr CardScore to_score(char ch)
+{
+	return detail::card_scores<Rules>[static_cast<unsigned char>(ch)];
+}
+
+enum class SetType : std::uint8_t
+{
+	High_card = 1,
+	One_pair = 2,
+	Two_pair = 3,
+	Three_of_a_kind = 4,
+	Full_house = 5,
+	Four_of_a_kind = 6,
+	Five_of_a_kind = 7,
+};
+
+inline std::string_view to_string(SetType set_type)
+{
+	switch (set_type)
+	{
+	case SetType::High_card:
+		return "High card";
+	case SetType::One_pair:
+		return "One pair";
+	case SetType::Two_pair:
+		return "Two pair";
+	case SetType::Three_of_a_kind:
+		return "Three of a kind";
+	case SetType::Full_house:
+		return "Full house";
+	case SetType::Four_of_a_kind:
+		return "Four of a kind";
+	case SetType::Five_of_a_kind:
+		return "Five of a kind";
+	}
+	return {};
+}
+
+namespace detail
+{
+
+constexpr std::size_t max_pairs = 10;
+
+// Groups of equal non-joker cards, largest first. Jokers always join the largest group.
+constexpr SetType classify(std::array<unsigned, 5> groups, unsigned size, unsigned jokers)
+{
+	const unsigned largest = (size ? groups[0] : 0) + jokers;
+	const unsigned second = size > 1 ? groups[1] : 0;
+	if (largest == 5)
+	{
+		return SetType::Five_of_a_kind;
+	}
+	if (largest == 4)
+	{
+		return SetType::Four_of_a_kind;
+	}
+	if (largest == 3)
+	{
+		return second == 2 ? SetType::Full_house : SetType::Three_of_a_kind;
+	}
+	if (largest == 2)
+	{
+		return second == 2 ? SetType::Two_pair : SetType::One_pair;
+	}
+	return SetType::High_card;
+}
+
+using SetTypes = std::array<std::array<SetType, max_pairs + 1>, 6>;
+
+// Enumerates every way to split the non-joker cards into groups of equal cards.
+constexpr void fill_set_types(
+	SetTypes & result,
+	unsigned jokers,
+	unsigned remaining,
+	std::array<unsigned, 5> groups,
+	unsigned size)
+{
+	if (!remaining)
+	{
+		unsigned pairs = 0;
+		for (unsigned i = 0; i < size; ++i)
+		{
+			pairs += groups[i] * (groups[i] - 1) / 2;
+		}
+		result[jokers][pairs] = classify(groups, size, jokers);
+		return;
+	}
+	const unsigned max_group = size ? std::min(groups[size - 1], remaining) : remaining;
+	for (unsigned group = max_group; group > 0; --group)
+	{
+		groups[size] = group;
+		fill_set_types(result, jokers, remaining - group, groups, size + 1);
+	}
+}
+
+constexpr SetTypes make_set_types()
+{
+	SetTypes result{};
+	for (unsigned jokers = 0; jokers <= 5; ++jokers)
+	{
+		fill_set_types(result, jokers, 5 - jokers, {}, 0);
+	}
+	return result;
+}
+
+// For five cards the number of equal (non-joker) card pairs identifies the shape of a hand: 10 for five of a kind,
+// 6 for four, 4 for a full house, 3 for three, 2 for two pairs, 1 for a pair and 0 otherwise. Together with the
+// joker count it indexes the hand type directly.
+constexpr SetTypes set_types = make_set_types();
+
+static_assert(set_types[0][4] == SetType::Full_house);
+static_assert(set_types[1][2] == SetType::Full_house);
+static_assert(set_types[2][0] == SetType::Three_of_a_kind);
+
+} // namespace detail
+
+template <typename Rules>
+class Set
+{
+public:
+	explicit Set(std::string_view card_codes)
+		: cards_{
+			to_score<Rules>(card_codes[0]),
+			to_score<Rules>(card_codes[1]),
+			to_score<Rules>(card_codes[2]),
+			to_score<Rules>(card_codes[3]),
+			to_score<Rules>(card_codes[4])}
+	{
+	}
+
+	SetType set_type() const
+	{
+		constexpr CardScore joker = to_score<Rules>('J');
+		unsigned jokers = 0;
+		unsigned pairs = 0;
+		for (std::size_t i = 0; i < 5; ++i)
+		{
+			const bool is_joker = Rules::jokers && cards_[i] == joker;
+			jokers += is_joker;
+			for (std::size_t j = i + 1; j < 5; ++j)
+			{
+				pairs += !is_joker && cards_[i] == cards_[j];
+			}
+		}
+		return detail::set_types[jokers][pairs];
+	}
+
+	// Hands are ordered by type first and then card by card, so packing the type above the five card scores (four bits
+	// each) gives an integer with the same order.
+	std::uint32_t sort_key() const
+	{
+		std::uint32_t key = static_cast<std::uint32_t>(set_type());
+		for (const CardScore card : cards_)
+		{
+			key = (key << 4) | static_cast<std::uint32_t>(card);
+		}
+		return key;
+	}
+
+	// Dense index of the hand among all 7 * 13^5 possible hands, in the same order as sort_key().
+	std::uint32_t compact_key() const
+	{
+		std::uint32_t key = static_cast<std::uint32_t>(set_type()) - 1;
+		for (const CardScore card : cards_)
+		{
+			key = key * cards_count + static_cast<std::uint32_t>(card) - 1;
+		}
+		return key;
+	}
+
+	static constexpr std::uint32_t cards_count = Rules::all_cards.size();
+	static constexpr std::uint32_t compact_keys =
+		7 * cards_count * cards_count * cards_count * cards_count * cards_count;
+
+	friend std::ostream & operator<<(std::ostream & out, const Set & set)
+	{
+		for (CardScore card : set.cards_)
+		{
+			out << Rules::all_cards[static_cast<std::size_t>(card) - 1];
+		}
+		return out;
+	}
+
+private:
+	CardScore cards_[5];
+};
+
+struct Hand
+{
+	std::uint32_t key;
+	unsigned bid;
+};
+
+template <typename Rules>
+struct SetWithBid
+{
+	Set<Rules> set;
+	unsigned bid;
+};
+
+// Lines have a fixed layout: five cards, a space and the bid.
+template <typename Rules>
+SetWithBid<Rules> parse_set(std::string_view line)
+{
+	const bool cards_valid = std::all_of(
+		line.begin(),
+		line.begin() + std::min<std::size_t>(line.size(), 5),
+		[](char ch)
+		{
+			return to_score<Rules>(ch) != CardScore{};
+		});
+	if (line.size() < 7 || line[5] != ' ' || !cards_valid)
+	{
+		throw std::invalid_argument("Bad hand \"" + std::string(line) + '"');
+	}
+	unsigned bid = 0;
+	const char * const end = line.data() + line.size();
+	const auto [ptr, ec] = std::from_chars(line.data() + 6, end, bid);
+	if (ec != std::errc() || ptr != end)
+	{
+		throw std::invalid_argument("Bad bid in \"" + std::string(line) + '"');
+	}
+	return {Set<Rules>(line.substr(0, 5)), bid};
+}
+
+template <typename Rules>
+Hand parse_hand(std::string_view line)
+{
+	const SetWithBid<Rules> hand = parse_set<Rules>(line);
+	return {hand.set.sort_key(), hand.bid};
+}
+
+// All hands whose lines start in [first, last), in input order.
+template <typename Rules>
+std::vector<Hand> parse_hands(std::string_view text, std::size_t first, std::size_t last)
+{
+	std::vector<Hand> result;
+	const std::size_t end = aoc::line_start(text, last);
+	for (std::size_t pos = aoc::line_start(text, first); pos < end;)
+	{
+		const std::size_t eol = std::min(text.find('\n', pos), text.size());
+		const std::string_view line = text.substr(pos, eol - pos);
+		if (!line.empty())
+		{
+			result.push_back(parse_hand<Rules>(line));
+		}
+		pos = eol + 1;
+	}
+	return result;
+}
+
+constexpr unsigned sort_key_bits = 24;
+
+// LSD radix sort on the precomputed key, one byte per pass. Every pass counts digits per band, turns the counts into
+// per-band output offsets (all smaller digits first, then the same digit from earlier bands) and lets each band
+// scatter its own slice, so the sort stays stable.
+inline void radix_sort(std::vector<Hand> & hands)
+{
+	using Counts = std::array<std::size_t, 256>;
+
+	std::vector<Hand> buffer(hands.size());
+	for (unsigned shift = 0; shift < sort_key_bits; shift += 8)
+	{
+		std::vector<Counts> offsets = aoc::run_bands(
+			hands.size(),
+			[&hands, shift](std::size_t first, std::size_t last)
+			{
+				Counts counts{};
+				for (std::size_t i = first; i < last; ++i)
+				{
+					++counts[(hands[i].key >> shift) & 0xFF];
+				}
+				return counts;
+			});
+
+		std::size_t offset = 0;
+		for (std::size_t digit = 0; digit < 256; ++digit)
+		{
+			for (Counts & band : offsets)
+			{
+				offset += std::exchange(band[digit], offset);
+			}
+		}
+
+		aoc::for_each_band(
+			hands.size(),
+			[&](std::size_t k, std::size_t first, std::size_t last)
+			{
+				Counts & next = offsets[k];
+				for (std::size_t i = first; i < last; ++i)
+				{
+					buffer[next[(hands[i].key >> shift) & 0xFF]++] = hands[i];
+				}
+			});
+		hands.swap(buffer);
+	}
+}
+
+class FenwickTree
+{
+public:
+	explicit FenwickTree(std::size_t size)
+		: tree_(size + 1)
+	{
+	}
+
+	void add(std::size_t idx, std::uint64_t value)
+	{
+		for (++idx; idx < tree_.size(); idx += idx & (~idx + 1))
+		{
+			tree_[idx] += value;
+		}
+	}
+
+	// Sum over [0, end).
+	std::uint64_t prefix(std::size_t end) const
+	{
+		std::uint64_t result = 0;
+		for (; end; end &= end - 1)
+		{
+			result += tree_[end];
+		}
+		return result;
+	}
+
+private:
+	std::vector<std::uint64_t> tree_;
+};
+
+// Live ranking of hands. Fenwick trees over the compact key space count hands and sum their bids, so inserting a
+// hand, asking for the rank of a hand and keeping the total winnings up to date are all O(log n) with no re-sorting.
+// Equal hands rank in insertion order.
+template <typename Rules>
+class HandBook
+{
+public:
+	HandBook()
+		: counts_(Set<Rules>::compact_keys)
+		, bids_(Set<Rules>::compact_keys)
+	{
+	}
+
+	void insert(const Set<Rules> & set, unsigned bid)
+	{
+		const std::uint32_t key = set.compact_key();
+		// Every hand ranked above the new one moves up a place and so adds its bid to the total once more.
+		const std::uint64_t rank = this->rank(set);
+		const std::uint64_t bids_above = total_bids_ - bids_.prefix(key + 1);
+		winnings_ += rank * bid + bids_above;
+
+		counts_.add(key, 1);
+		bids_.add(key, bid);
+		total_bids_ += bid;
+	}
+
+	// Rank `set` would get if it was inserted now, counting from 1. It goes after the equal hands inserted so far.
+	std::uint64_t rank(const Set<Rules> & set) const
+	{
+		return counts_.prefix(set.compact_key() + 1) + 1;
+	}
+
+	std::uint64_t winnings() const
+	{
+		return winnings_;
+	}
+
+private:
+	FenwickTree counts_;
+	FenwickTree bids_;
+	std::uint64_t total_bids_ = 0;
+	std::uint64_t winnings_ = 0;
+};
+
+// Parses, sorts and scores the hands in parallel: bands of the mapped input are parsed into sort keys concurrently,
+// sorted by a banded radix sort and summed as rank * bid per band.
+template <typename Rules>
+int solve(std::string_view input_file)
+{
+	const aoc::MappedFile file(input_file.data());
+	const std::string_view text = file.view();
+
+	const auto bands = aoc::run_bands(
+		text.size(),
+		[text](std::size_t first, std::size_t last)
+		{
+			return parse_hands<Rules>(text, first, last);
+		});
+
+	std::vector<Hand> hands;
+	for (const std::vector<Hand> & band : bands)
+	{
+		hands.insert(hands.end(), band.begin(), band.end());
+	}
+
+	radix_sort(hands);
+
+	const auto winnings = aoc::run_bands(
+		hands.size(),
+		[&hands](std::size_t first, std::size_t last)
+		{
+			std::uint64_t result = 0;
+			for (std::size_t i = first; i < last; ++i)
+			{
+				result += (i + 1) * std::uint64_t{hands[i].bid};
+			}
+			return result;
+		});
+	std::cout << std::accumulate(winnings.begin(), winnings.end(), std::uint64_t{0}) << '\n';
+
+	return 0;
+}
+
+// Streams the hands into a HandBook in input order and reports the rank every hand enters at along with the running
+// winnings. The last line is the total winnings, as with solve().
+template <typename Rules>
+int solve_live(std::string_view input_file)
+{
+	std::ifstream input(input_file.data());
+
+	HandBook<Rules> book;
+	std::string line;
+	while (std::getline(input, line))
+	{
+		if (line.empty())
+		{
+			continue;
+		}
+		const SetWithBid<Rules> hand = parse_set<Rules>(line);
+		const std::uint64_t rank = book.rank(hand.set);
+		book.insert(hand.set, hand.bid);
+		std::cout << hand.set << " (" << to_string(hand.set.set_type()) << ") rank " << rank << ", winnings "
+				  << book.winnings() << '\n';
+	}
+	std::cout << book.winnings() << '\n';
+
+	return 0;
+}
+
+} // namespace day7
@@ -1,92 +1,332 @@
+#include "8.h"
+#include "common.h"
 #include "h.h"
 
 #include <algorithm>
 #include <cstdint>
-#include <fstream>
 #include <iostream>
-#include <numeric>
+#include <limits>
+#include <optional>
 #include <span>
-#include <unordered_map>
+#include <stdexcept>
+#include <string>
+#include <utility>
 #include <vector>
 
 namespace
 {
 
-using namespace std::string_view_literals;
+using uint128 = unsigned __int128;
 
-std::vector<bool> parse_instructions(std::string_view line)
+std::string to_string(uint128 value)
 {
-	std::vector<bool> result;
-	while (!line.empty())
+	std::string result;
+	do
 	{
-		result.push_back(line[0] == 'R');
-		line = line.substr(1);
+		result.push_back(static_cast<char>('0' + value % 10));
+		value /= 10;
 	}
+	while (value);
+	std::reverse(result.begin(), result.end());
 	return result;
 }
 
-using Node = std::pair<std::string, std::pair<std::string, std::string>>;
+uint128 gcd(uint128 a, uint128 b)
+{
+	while (b)
+	{
+		a = std::exchange(b, a % b);
+	}
+	return a;
+}
 
-Node parse_node(std::string_view line)
+// Inverse of `a` modulo `n` for coprime a and n.
+std::uint64_t inverse(std::uint64_t a, std::uint64_t n)
 {
-	Node result;
-	std::size_t e = 0;
-	e = line.find_first_of(' ');
-	result.first = std::string(line.substr(0, e));
-	line = line.substr(line.find_first_of('(') + 1);
-	e = line.find_first_of(',');
-	result.second.first = line.substr(0, e);
-	line = line.substr(line.find_first_of(' ') + 1);
-	e = line.find_first_of(')');
-	result.second.second = std::string(line.substr(0, e));
-	return result;
+	__int128 r0 = n;
+	__int128 r1 = a % n;
+	__int128 t0 = 0;
+	__int128 t1 = 1;
+	while (r1)
+	{
+		const __int128 q = r0 / r1;
+		r0 = std::exchange(r1, r0 - q * r1);
+		t0 = std::exchange(t1, t0 - q * t1);
+	}
+	return static_cast<std::uint64_t>(t0 < 0 ? t0 + n : t0);
 }
 
-uint64_t get_single_path_len(
-	const std::unordered_map<std::string, std::pair<std::string, std::string>> & map,
-	std::string start_point,
-	std::vector<bool> instructions)
+// One full pass over the instructions from every node: where it ends and at which offsets within the pass the walk
+// stands on a '..Z' node.
+class BlockTable
 {
-	auto next_instruction = [idx = std::size_t(0), instructions = std::move(instructions)]() mutable -> bool
+public:
+	explicit BlockTable(const day8::Map & map)
+		: length_(map.instructions.size())
+		, next_(map.network.size())
+		, hits_begin_{0}
 	{
-		auto rv = instructions[idx];
-		if (++idx == instructions.size())
+		struct BandHits
+		{
+			std::vector<std::uint64_t> hits;
+			std::vector<std::size_t> ends;
+		};
+
+		// Passes from different nodes are independent. Every band collects its own hits; they are stitched together
+		// in node order afterwards.
+		const auto bands = aoc::run_bands(
+			next_.size(),
+			[this, &map](std::size_t first, std::size_t last)
+			{
+				BandHits result;
+				for (std::size_t node = first; node < last; ++node)
+				{
+					day8::NodeId current = static_cast<day8::NodeId>(node);
+					for (std::size_t idx = 0; idx < length_; ++idx)
+					{
+						if (map.network.is_end(current))
+						{
+							result.hits.push_back(idx);
+						}
+						current = map.network.step(current, map.instructions[idx]);
+					}
+					next_[node] = current;
+					result.ends.push_back(result.hits.size());
+				}
+				return result;
+			});
+		for (const BandHits & band : bands)
 		{
-			idx = 0;
+			const std::size_t base = hits_.size();
+			hits_.insert(hits_.end(), band.hits.begin(), band.hits.end());
+			for (const std::size_t end : band.ends)
+			{
+				hits_begin_.push_back(base + end);
+			}
 		}
-		return rv;
-	};
+	}
+
+	std::uint64_t length() const
+	{
+		return length_;
+	}
+
+	std::size_t size() const
+	{
+		return next_.size();
+	}
 
-	auto node_it = map.find(start_point);
-	if (node_it == map.end())
+	day8::NodeId next(day8::NodeId node) const
 	{
-		throw std::logic_error("No " + start_point + " node");
+		return next_[node];
 	}
-	unsigned len = 0;
-	while (!node_it->first.ends_with("Z"))
+
+	std::span<const std::uint64_t> hits(day8::NodeId node) const
 	{
-		++len;
-		const auto & next = next_instruction() ? node_it->second.second : node_it->second.first;
-		std::cout << "next = " << next << '\n';
-		node_it = map.find(next);
+		return std::span(hits_).subspan(hits_begin_[node], hits_begin_[node + 1] - hits_begin_[node]);
 	}
-	return len;
+
+private:
+	std::uint64_t length_;
+	std::vector<day8::NodeId> next_;
+	std::vector<std::uint64_t> hits_;
+	std::vector<std::size_t> hits_begin_;
+};
+
+// Step counts at which a ghost stands on a '..Z' node, as an eventually periodic set: `tail` below `cycle_start`, and
+// from there on `residues` (modulo `period`) forever.
+struct GhostPath
+{
+	std::uint64_t cycle_start;
+	std::uint64_t period;
+	std::vector<std::uint64_t> tail;
+	std::vector<std::uint64_t> residues;
+
+	bool contains(uint128 steps) const
+	{
+		if (steps < cycle_start)
+		{
+			return std::binary_search(tail.begin(), tail.end(), static_cast<std::uint64_t>(steps));
+		}
+		return std::binary_search(residues.begin(), residues.end(), static_cast<std::uint64_t>(steps % period));
+	}
+};
+
+GhostPath trace(const BlockTable & blocks, day8::NodeId start)
+{
+	// Brent's algorithm on whole passes: the walk state (node, instruction index) repeats exactly when the node at a
+	// pass boundary does, since the index is zero there.
+	std::uint64_t power = 1;
+	std::uint64_t lambda = 1;
+	day8::NodeId tortoise = start;
+	day8::NodeId hare = blocks.next(start);
+	while (tortoise != hare)
+	{
+		if (power == lambda)
+		{
+			tortoise = hare;
+			power *= 2;
+			lambda = 0;
+		}
+		hare = blocks.next(hare);
+		++lambda;
+	}
+
+	tortoise = hare = start;
+	for (std::uint64_t i = 0; i < lambda; ++i)
+	{
+		hare = blocks.next(hare);
+	}
+	std::uint64_t mu = 0;
+	while (tortoise != hare)
+	{
+		tortoise = blocks.next(tortoise);
+		hare = blocks.next(hare);
+		++mu;
+	}
+
+	const std::uint64_t block_len = blocks.length();
+	GhostPath result{mu * block_len, lambda * block_len, {}, {}};
+	day8::NodeId node = start;
+	for (std::uint64_t block = 0; block < mu + lambda; ++block)
+	{
+		for (const std::uint64_t hit : blocks.hits(node))
+		{
+			const std::uint64_t steps = block * block_len + hit;
+			if (block < mu)
+			{
+				result.tail.push_back(steps);
+			}
+			else
+			{
+				result.residues.push_back(steps % result.period);
+			}
+		}
+		node = blocks.next(node);
+	}
+	std::sort(result.residues.begin(), result.residues.end());
+	return result;
 }
 
-std::uint64_t get_path_len(
-	std::unordered_map<std::string, std::pair<std::string, std::string>> map,
-	std::vector<bool> instructions)
+// Step counts modulo `modulus` that every ghost combined so far accepts.
+struct Residues
 {
-	std::uint64_t result = 1;
-	for (const auto & [k, v] : map)
+	uint128 modulus;
+	std::vector<uint128> values;
+};
+
+// Generalized CRT: x = a (mod m) and x = b (mod n) have a common solution iff gcd(m, n) divides b - a, and it is
+// unique modulo lcm(m, n).
+Residues combine(const Residues & acc, const GhostPath & path)
+{
+	const uint128 m = acc.modulus;
+	const std::uint64_t n = path.period;
+	const std::uint64_t g = static_cast<std::uint64_t>(gcd(m, n));
+	if (m / g > std::numeric_limits<uint128>::max() / n)
+	{
+		throw std::overflow_error("Common ghost period does not fit into 128 bits");
+	}
+	const std::uint64_t reduced = n / g;
+	const std::uint64_t inv = inverse(static_cast<std::uint64_t>((m / g) % reduced), reduced);
+
+	Residues result{m / g * n, {}};
+	for (const uint128 a : acc.values)
+	{
+		const std::uint64_t a_mod_n = static_cast<std::uint64_t>(a % n);
+		for (const std::uint64_t b : path.residues)
+		{
+			const std::uint64_t diff = b >= a_mod_n ? b - a_mod_n : b + (n - a_mod_n);
+			if (diff % g)
+			{
+				continue;
+			}
+			const std::uint64_t k = static_cast<std::uint64_t>(uint128(diff / g) * inv % reduced);
+			result.values.push_back(a + m * k);
+		}
+	}
+	std::sort(result.values.begin(), result.values.end());
+	result.values.erase(std::unique(result.values.begin(), result.values.end()), result.values.end());
+	return result;
+}
+
+std::optional<uint128> get_path_len(const std::vector<GhostPath> & paths)
+{
+	// Below the latest cycle start only tail hits of that ghost are candidates; check them in order.
+	const GhostPath & latest = *std::max_element(
+		paths.begin(),
+		paths.end(),
+		[](const GhostPath & lhs, const GhostPath & rhs)
+		{
+			return lhs.cycle_start < rhs.cycle_start;
+		});
+	for (const std::uint64_t steps : latest.tail)
+	{
+		const bool everyone = std::all_of(
+			paths.begin(),
+			paths.end(),
+			[steps](const GhostPath & path)
+			{
+				return path.contains(steps);
+			});
+		if (everyone)
+		{
+			return steps;
+		}
+	}
+
+	// From there on every ghost is periodic. Ghosts that share a cycle only need to be combined once, and combining the
+	// sparsest ones first keeps the intermediate residue sets small.
+	std::vector<const GhostPath *> periodic;
+	for (const GhostPath & path : paths)
+	{
+		periodic.push_back(&path);
+	}
+	std::sort(
+		periodic.begin(),
+		periodic.end(),
+		[](const GhostPath * lhs, const GhostPath * rhs)
+		{
+			if (lhs->residues.size() != rhs->residues.size())
+			{
+				return lhs->residues.size() < rhs->residues.size();
+			}
+			if (lhs->period != rhs->period)
+			{
+				return lhs->period < rhs->period;
+			}
+			return lhs->residues < rhs->residues;
+		});
+	periodic.erase(
+		std::unique(
+			periodic.begin(),
+			periodic.end(),
+			[](const GhostPath * lhs, const GhostPath * rhs)
+			{
+				return lhs->period == rhs->period && lhs->residues == rhs->residues;
+			}),
+		periodic.end());
+
+	Residues acc{1, {0}};
+	for (const GhostPath * path : periodic)
 	{
-		if (k.ends_with("A"))
+		acc = combine(acc, *path);
+		if (acc.values.empty())
 		{
-			std::cout << k << ":\n";
-			auto len = get_single_path_len(map, k, instructions);
-			std::cout << "len = " << len << "\n";
-			std::cout << "===\n";
-			result = std::lcm<std::uint64_t>(result, len);
+			return std::nullopt;
+		}
+	}
+
+	std::optional<uint128> result;
+	for (const uint128 value : acc.values)
+	{
+		uint128 steps = value;
+		if (steps < latest.cycle_start)
+		{
+			steps += (latest.cycle_start - steps + acc.modulus - 1) / acc.modulus * acc.modulus;
+		}
+		if (!result || steps < *result)
+		{
+			result = steps;
 		}
 	}
 	return result;
@@ -96,21 +336,53 @@ std::uint64_t get_path_len(
 
 int task_8_2(std::string_view input_file)
 {
-	std::ifstream input(input_file.data());
+	const day8::Map map = day8::read_map(input_file);
+	const BlockTable blocks(map);
 
-	std::string line;
-	std::getline(input, line);
-	const auto instructions = parse_instructions(line);
-	std::getline(input, line);
+	std::vector<day8::NodeId> starts;
+	for (std::size_t node = 0; node < map.network.size(); ++node)
+	{
+		if (map.network.is_start(static_cast<day8::NodeId>(node)))
+		{
+			starts.push_back(static_cast<day8::NodeId>(node));
+		}
+	}
+	if (starts.empty())
+	{
+		throw std::logic_error("No ..A nodes");
+	}
+
+	// Ghosts only read the shared tables, so they are traced independently.
+	const auto bands = aoc::run_bands(
+		starts.size(),
+		[&](std::size_t first, std::size_t last)
+		{
+			std::vector<GhostPath> result;
+			for (std::size_t i = first; i < last; ++i)
+			{
+				result.push_back(trace(blocks, starts[i]));
+			}
+			return result;
+		});
+
+	std::vector<GhostPath> paths;
+	std::size_t start = 0;
+	for (const std::vector<GhostPath> & band : bands)
+	{
+		for (const GhostPath & path : band)
+		{
+			std::cout << map.network.name(starts[start++]) << ": cycle of " << path.period << " from "
+					  << path.cycle_start << ", " << path.tail.size() << " + " << path.residues.size() << " hits\n";
+			paths.push_back(path);
+		}
+	}
 
-	std::unordered_map<std::string, std::pair<std::string, std::string>> map;
-	while (!input.bad() && !input.eof())
+	const std::optional<uint128> result = get_path_len(paths);
+	if (!result)
 	{
-		std::getline(input, line);
-		map.insert(parse_node(line));
+		throw std::logic_error("Ghosts never stand on ..Z nodes at the same time");
 	}
-	std::uint64_t result = get_path_len(std::move(map), std::move(instructions));
-	std::cout << result << '\n';
+	std::cout << to_string(*result) << '\n';
 
 	return 0;
 }
@@ -0,0 +1,191 @@
+#pragma once
+
+#include <array>
+#include <cstdint>
+#include <fstream>
+#include <stdexcept>
+#include <string>
+#include <string_view>
+#include <vector>
+
+// Haunted Wasteland network shared by both parts of day 8.
+namespace day8
+{
+
+using NodeId = std::uint16_t;
+
+enum Direction : std::uint8_t
+{
+	Left = 0,
+	Right = 1,
+};
+
+inline std::vector<Direction> parse_instructions(std::string_view line)
+{
+	std::vector<Direction> result;
+	result.reserve(line.size());
+	for (const char ch : line)
+	{
+		result.push_back(ch == 'R' ? Right : Left);
+	}
+	return result;
+}
+
+// Node names are interned into dense ids while parsing, so a step is a single array load and the '..A' / '..Z' tests
+// are bit lookups.
+class Network
+{
+public:
+	// "AAA = (BBB, CCC)"
+	void add(std::string_view line)
+	{
+		if (line.size() != 16 || line.substr(3, 4) != " = (" || line.substr(10, 2) != ", " || line[15] != ')')
+		{
+			throw std::invalid_argument("Bad node \"" + std::string(line) + '"');
+		}
+		const NodeId node = intern(line.substr(0, 3));
+		const NodeId left = intern(line.substr(7, 3));
+		const NodeId right = intern(line.substr(12, 3));
+		if (defined_[node])
+		{
+			throw std::logic_error("Node " + std::string(line.substr(0, 3)) + " is defined twice");
+		}
+		next_[Left][node] = left;
+		next_[Right][node] = right;
+		defined_[node] = true;
+	}
+
+	// Every referenced node must have been defined.
+	void validate() const
+	{
+		for (std::size_t node = 0; node < size(); ++node)
+		{
+			if (!defined_[node])
+			{
+				throw std::logic_error("Node " + names_[node] + " has no connections");
+			}
+		}
+	}
+
+	std::size_t size() const
+	{
+		return names_.size();
+	}
+
+	NodeId find(std::string_view name) const
+	{
+		const std::uint32_t code = encode(name);
+		if (ids_[code] == no_node)
+		{
+			throw std::logic_error("No " + std::string(name) + " node");
+		}
+		return ids_[code];
+	}
+
+	NodeId step(NodeId node, Direction direction) const
+	{
+		return next_[direction][node];
+	}
+
+	bool is_start(NodeId node) const
+	{
+		return starts_[node];
+	}
+
+	bool is_end(NodeId node) const
+	{
+		return ends_[node];
+	}
+
+	const std::string & name(NodeId node) const
+	{
+		return names_[node];
+	}
+
+private:
+	static constexpr std::uint32_t name_codes = 36 * 36 * 36;
+	static constexpr NodeId no_node = 0xFFFF;
+	static_assert(name_codes < no_node);
+
+	// Names are three characters from [0-9A-Z], read as a base 36 number.
+	static std::uint32_t encode(std::string_view name)
+	{
+		if (name.size() != 3)
+		{
+			throw std::invalid_argument("Bad node name \"" + std::string(name) + '"');
+		}
+		std::uint32_t result = 0;
+		for (const char ch : name)
+		{
+			std::uint32_t digit = 0;
+			if (ch >= '0' && ch <= '9')
+			{
+				digit = ch - '0';
+			}
+			else if (ch >= 'A' && ch <= 'Z')
+			{
+				digit = ch - 'A' + 10;
+			}
+			else
+			{
+				throw std::invalid_argument("Bad node name \"" + std::string(name) + '"');
+			}
+			result = result * 36 + digit;
+		}
+		return result;
+	}
+
+	NodeId intern(std::string_view name)
+	{
+		NodeId & id = ids_[encode(name)];
+		if (id == no_node)
+		{
+			id = static_cast<NodeId>(names_.size());
+			names_.emplace_back(name);
+			next_[Left].push_back(id);
+			next_[Right].push_back(id);
+			starts_.push_back(name.back() == 'A');
+			ends_.push_back(name.back() == 'Z');
+			defined_.push_back(false);
+		}
+		return id;
+	}
+
+	std::vector<NodeId> ids_ = std::vector<NodeId>(name_codes, no_node);
+	std::vector<std::string> names_;
+	std::array<std::vector<NodeId>, 2> next_;
+	std::vector<bool> starts_;
+	std::vector<bool> ends_;
+	std::vector<bool> defined_;
+};
+
+struct Map
+{
+	std::vector<Direction> instructions;
+	Network network;
+};
+
+inline Map read_map(std::string_view input_file)
+{
+	std::ifstream input(input_file.data());
+
+	Map result;
+	std::string line;
+	std::getline(input, line);
+	result.instructions = parse_instructions(line);
+	if (result.instructions.empty())
+	{
+		throw std::logic_error("No instructions");
+	}
+	while (std::getline(input, line))
+	{
+		if (!line.empty())
+		{
+			result.network.add(line);
+		}
+	}
+	result.network.validate();
+	return result;
+}
+
+} // namespace day8
@@ -0,0 +1,376 @@
+#pragma once
+
+#include <algorithm>
+#include <array>
+#include <charconv>
+#include <cstdint>
+#include <fstream>
+#include <iostream>
+#include <limits>
+#include <map>
+#include <span>
+#include <stdexcept>
+#include <string>
+#include <string_view>
+#include <vector>
+
+// Mirage Maintenance extrapolation shared by both parts of day 9.
+namespace day9
+{
+
+// Parses space-separated values into `values`, reusing its storage.
+inline void parse_values(std::string_view line, std::vector<std::int64_t> & values)
+{
+	values.clear();
+	const char * pos = line.data();
+	const char * const end = line.data() + line.size();
+	while (pos != end)
+	{
+		if (*pos == ' ')
+		{
+			++pos;
+			continue;
+		}
+		std::int64_t value = 0;
+		const auto [ptr, ec] = std::from_chars(pos, end, value);
+		if (ec != std::errc() || (ptr != end && *ptr != ' '))
+		{
+			throw std::invalid_argument("Bad number in \"" + std::string(line) + '"');
+		}
+		values.push_back(value);
+		pos = ptr;
+	}
+}
+
+// Extrapolating through the difference pyramid is linear in the inputs. For n values the next one is
+// sum((-1)^(n-1-i) * C(n, i) * x[i]) and the previous one is sum((-1)^i * C(n, i+1) * x[i]); the pyramid stopping early
+// at an all-zero level gives the same result, since the levels it skips contribute zeros. It reaches an all-zero level
+// exactly when its single-value top level, sum((-1)^(n-1-i) * C(n-1, i) * x[i]), is zero.
+constexpr std::size_t max_length = 66; // C(66, 33) is the largest central binomial coefficient that fits into 64 bits
+
+struct Weights
+{
+	std::array<std::int64_t, max_length> next;
+	std::array<std::int64_t, max_length> previous;
+	std::array<std::int64_t, max_length> top;
+};
+
+namespace detail
+{
+
+constexpr std::array<Weights, max_length + 1> make_weights()
+{
+	std::array<std::array<std::int64_t, max_length + 1>, max_length + 1> binomials{};
+	for (std::size_t n = 0; n <= max_length; ++n)
+	{
+		binomials[n][0] = binomials[n][n] = 1;
+		for (std::size_t k = 1; k < n; ++k)
+		{
+			binomials[n][k] = binomials[n - 1][k - 1] + binomials[n - 1][k];
+		}
+	}
+
+	std::array<Weights, max_length + 1> result{};
+	for (std::size_t n = 1; n <= max_length; ++n)
+	{
+		for (std::size_t i = 0; i < n; ++i)
+		{
+			result[n].next[i] = (n - 1 - i) % 2 ? -binomials[n][i] : binomials[n][i];
+			result[n].previous[i] = i % 2 ? -binomials[n][i + 1] : binomials[n][i + 1];
+			result[n].top[i] = (n - 1 - i) % 2 ? -binomials[n - 1][i] : binomials[n - 1][i];
+		}
+	}
+	return result;
+}
+
+} // namespace detail
+
+constexpr std::array<Weights, max_length + 1> weights = detail::make_weights();
+
+static_assert(weights[3].next[0] == 1 && weights[3].next[1] == -3 && weights[3].next[2] == 3);
+static_assert(weights[3].previous[0] == 3 && weights[3].previous[1] == -3 && weights[3].previous[2] == 1);
+static_assert(weights[3].top[0] == 1 && weights[3].top[1] == -2 && weights[3].top[2] == 1);
+
+inline const Weights & weights_for(std::size_t length)
+{
+	if (!length || length > max_length)
+	{
+		throw std::length_error("Cannot extrapolate a sequence of " + std::to_string(length) + " values");
+	}
+	return weights[length];
+}
+
+enum class Direction
+{
+	Next,
+	Previous,
+};
+
+struct Prediction
+{
+	std::int64_t next = 0;
+	std::int64_t previous = 0;
+	// False when no level of differences became all zero, i.e. the values are not a polynomial of degree below n - 1
+	// and the prediction is only the unique interpolating polynomial.
+	bool converged = true;
+};
+
+struct Totals
+{
+	std::int64_t next = 0;
+	std::int64_t previous = 0;
+	std::size_t sequences = 0;
+	std::size_t non_converged = 0;
+};
+
+namespace detail
+{
+
+inline std::int64_t checked_sub(std::int64_t lhs, std::int64_t rhs)
+{
+	std::int64_t result;
+	if (__builtin_sub_overflow(lhs, rhs, &result))
+	{
+		throw std::overflow_error("Difference does not fit into 64 bits");
+	}
+	return result;
+}
+
+inline std::int64_t checked_add(std::int64_t lhs, std::int64_t rhs)
+{
+	std::int64_t result;
+	if (__builtin_add_overflow(lhs, rhs, &result))
+	{
+		throw std::overflow_error("Extrapolated value does not fit into 64 bits");
+	}
+	return result;
+}
+
+} // namespace detail
+
+// Builds the difference pyramid in place, one level at a time, until a level is all zero. Level k lives in
+// values[0, n - k), so the last value of every earlier level stays behind it; the first values are overwritten and
+// are kept aside. Both directions come out of the same pass.
+inline Prediction extrapolate_in_place(std::span<std::int64_t> values)
+{
+	const auto is_zero = [](std::int64_t value)
+	{
+		return value == 0;
+	};
+	std::vector<std::int64_t> firsts;
+	std::size_t length = values.size();
+	while (length && !std::all_of(values.begin(), values.begin() + length, is_zero))
+	{
+		firsts.push_back(values[0]);
+		for (std::size_t i = 0; i + 1 < length; ++i)
+		{
+			values[i] = detail::checked_sub(values[i + 1], values[i]);
+		}
+		--length;
+	}
+
+	Prediction result{0, 0, length != 0};
+	for (const std::int64_t last : values.subspan(length))
+	{
+		result.next = detail::checked_add(result.next, last);
+	}
+	for (std::size_t i = firsts.size(); i-- > 0;)
+	{
+		result.previous = detail::checked_sub(firsts[i], result.previous);
+	}
+	return result;
+}
+
+// Sequences grouped by length. Each group is stored column-major, one column per position, so that the same
+// position of every sequence in a group is contiguous and a group is processed as a block of equal-length lanes
+// sharing one row of weights.
+class SequenceBatch
+{
+public:
+	using Columns = std::vector<std::vector<std::int64_t>>;
+
+	void add(std::span<const std::int64_t> values)
+	{
+		if (values.empty())
+		{
+			return;
+		}
+		Columns & columns = groups_[values.size()];
+		columns.resize(values.size());
+		for (std::size_t i = 0; i < values.size(); ++i)
+		{
+			columns[i].push_back(values[i]);
+		}
+	}
+
+	// Calls `f(length, columns)` for every group; columns[i][row] is value i of sequence `row`.
+	template <typename F>
+	void for_each_group(F && f) const
+	{
+		for (const auto & [length, columns] : groups_)
+		{
+			f(length, columns);
+		}
+	}
+
+private:
+	std::map<std::size_t, Columns> groups_;
+};
+
+namespace detail
+{
+
+inline std::int64_t narrow(__int128 value)
+{
+	if (value < std::numeric_limits<std::int64_t>::min() || value > std::numeric_limits<std::int64_t>::max())
+	{
+		throw std::overflow_error("Extrapolated value does not fit into 64 bits");
+	}
+	return static_cast<std::int64_t>(value);
+}
+
+inline void checked_add(__int128 & sum, std::int64_t weight, std::int64_t value)
+{
+	__int128 term;
+	if (__builtin_mul_overflow(__int128{weight}, __int128{value}, &term) || __builtin_add_overflow(sum, term, &sum))
+	{
+		throw std::overflow_error("Extrapolation does not fit into 128 bits");
+	}
+}
+
+// With the next, previous and top weights of length n each summing to at most 2^n - 1 in absolute value, no partial
+// sum of a sequence can overflow 64 bits once every |x| <= INT64_MAX >> n.
+inline bool fits_lanes(std::size_t length, const SequenceBatch::Columns & columns)
+{
+	if (length >= 63)
+	{
+		return false;
+	}
+	const std::uint64_t limit = std::numeric_limits<std::int64_t>::max() >> length;
+	const auto fits = [limit](std::int64_t value)
+	{
+		return (value < 0 ? 0 - static_cast<std::uint64_t>(value) : static_cast<std::uint64_t>(value)) <= limit;
+	};
+	return std::all_of(
+		columns.begin(),
+		columns.end(),
+		[&fits](const std::vector<std::int64_t> & column)
+		{
+			return std::all_of(column.begin(), column.end(), fits);
+		});
+}
+
+} // namespace detail
+
+// Predicts the next and the previous value of a sequence and whether it converges, in one checked pass over it.
+// Sequences too long for the weight table go through the difference pyramid instead.
+inline Prediction predict(std::span<const std::int64_t> values)
+{
+	if (values.size() > max_length)
+	{
+		std::vector<std::int64_t> buffer(values.begin(), values.end());
+		return extrapolate_in_place(buffer);
+	}
+
+	const Weights & w = weights_for(values.size());
+	__int128 next = 0;
+	__int128 previous = 0;
+	__int128 top = 0;
+	for (std::size_t i = 0; i < values.size(); ++i)
+	{
+		detail::checked_add(next, w.next[i], values[i]);
+		detail::checked_add(previous, w.previous[i], values[i]);
+		detail::checked_add(top, w.top[i], values[i]);
+	}
+	return {detail::narrow(next), detail::narrow(previous), top == 0};
+}
+
+// Sums the predictions of every sequence in the batch and counts the sequences that do not converge.
+inline Totals predict_all(const SequenceBatch & batch)
+{
+	__int128 next = 0;
+	__int128 previous = 0;
+	Totals result;
+	batch.for_each_group(
+		[&](std::size_t length, const SequenceBatch::Columns & columns)
+		{
+			const std::size_t count = columns[0].size();
+			result.sequences += count;
+			if (detail::fits_lanes(length, columns))
+			{
+				// Plain 64-bit lanes, one sequence per lane: for every position the inner loop runs over a block of
+				// contiguous sequences with the same weights and no checks. It vectorises wherever the target has
+				// packed 64-bit multiplies (e.g. -mavx2); baseline SSE2 has none, so there it stays scalar.
+				constexpr std::size_t block = 256;
+				const Weights & w = weights[length];
+				std::array<std::int64_t, block> block_next;
+				std::array<std::int64_t, block> block_previous;
+				std::array<std::int64_t, block> block_top;
+				for (std::size_t first = 0; first < count; first += block)
+				{
+					const std::size_t width = std::min(block, count - first);
+					block_next.fill(0);
+					block_previous.fill(0);
+					block_top.fill(0);
+					for (std::size_t i = 0; i < length; ++i)
+					{
+						const std::int64_t * const x = columns[i].data() + first;
+						for (std::size_t lane = 0; lane < width; ++lane)
+						{
+							block_next[lane] += w.next[i] * x[lane];
+							block_previous[lane] += w.previous[i] * x[lane];
+							block_top[lane] += w.top[i] * x[lane];
+						}
+					}
+					for (std::size_t lane = 0; lane < width; ++lane)
+					{
+						next += block_next[lane];
+						previous += block_previous[lane];
+						result.non_converged += block_top[lane] != 0;
+					}
+				}
+				return;
+			}
+			std::vector<std::int64_t> values(length);
+			for (std::size_t row = 0; row < count; ++row)
+			{
+				for (std::size_t i = 0; i < length; ++i)
+				{
+					values[i] = columns[i][row];
+				}
+				const Prediction prediction = predict(values);
+				next += prediction.next;
+				previous += prediction.previous;
+				result.non_converged += !prediction.converged;
+			}
+		});
+	result.next = detail::narrow(next);
+	result.previous = detail::narrow(previous);
+	return result;
+}
+
+// Both directions come out of the same pass; the part only decides which one to print.
+inline int solve(std::string_view input_file, Direction direction)
+{
+	std::ifstream input(input_file.data());
+
+	SequenceBatch batch;
+	std::string line;
+	std::vector<std::int64_t> values;
+	while (std::getline(input, line))
+	{
+		parse_values(line, values);
+		batch.add(values);
+	}
+
+	const Totals totals = predict_all(batch);
+	if (totals.non_converged)
+	{
+		std::cout << totals.non_converged << " of " << totals.sequences << " sequences do not converge\n";
+	}
+	std::cout << (direction == Direction::Next ? totals.next : totals.previous) << '\n';
+
+	return 0;
+}
+
+} // namespace day9
@@ -0,0 +1,137 @@
+#pragma once
+
+#include <algorithm>
+#include <cerrno>
+#include <cstddef>
+#include <exception>
+#include <string_view>
+#include <system_error>
+#include <thread>
+#include <vector>
+
+#include <fcntl.h>
+#include <sys/mman.h>
+#include <sys/stat.h>
+#include <unistd.h>
+
+// Input mapping and banded parallelism shared by the tasks.
+namespace aoc
+{
+
+class MappedFile
+{
+public:
+	explicit MappedFile(const char * path)
+	{
+		const int fd = ::open(path, O_RDONLY);
+		if (fd == -1)
+		{
+			throw std::system_error(errno, std::generic_category(), path);
+		}
+		struct stat st
+		{
+		};
+		if (::fstat(fd, &st) == -1)
+		{
+			::close(fd);
+			throw std::system_error(errno, std::generic_category(), path);
+		}
+		size_ = static_cast<std::size_t>(st.st_size);
+		if (size_)
+		{
+			data_ = ::mmap(nullptr, size_, PROT_READ, MAP_PRIVATE, fd, 0);
+		}
+		::close(fd);
+		if (data_ == MAP_FAILED)
+		{
+			throw std::system_error(errno, std::generic_category(), path);
+		}
+	}
+
+	MappedFile(const MappedFile &) = delete;
+	MappedFile & operator=(const MappedFile &) = delete;
+
+	~MappedFile()
+	{
+		if (data_)
+		{
+			::munmap(data_, size_);
+		}
+	}
+
+	std::string_view view() const
+	{
+		return {static_cast<const char *>(data_), size_};
+	}
+
+private:
+	void * data_ = nullptr;
+	std::size_t size_ = 0;
+};
+
+inline std::size_t band_count(std::size_t size)
+{
+	return std::min<std::size_t>(size, std::max(1u, std::thread::hardware_concurrency()));
+}
+
+// Splits [0, size) into band_count(size) bands and runs `f(band, first, last)` for each band concurrently. An exception
+// thrown by `f` is rethrown on the calling thread once every band has finished; the one of the earliest band wins.
+template <typename F>
+void for_each_band(std::size_t size, F && f)
+{
+	const std::size_t bands = band_count(size);
+	std::vector<std::exception_ptr> errors(bands);
+	{
+		std::vector<std::jthread> workers;
+		workers.reserve(bands);
+		for (std::size_t k = 0; k < bands; ++k)
+		{
+			workers.emplace_back(
+				[&f, &errors, size, bands, k]
+				{
+					try
+					{
+						f(k, size * k / bands, size * (k + 1) / bands);
+					}
+					catch (...)
+					{
+						errors[k] = std::current_exception();
+					}
+				});
+		}
+	}
+	for (const std::exception_ptr & error : errors)
+	{
+		if (error)
+		{
+			std::rethrow_exception(error);
+		}
+	}
+}
+
+// Same bands as for_each_band(), collecting `f(first, last)` of every band in band order.
+template <typename F>
+auto run_bands(std::size_t size, F && f)
+{
+	std::vector<decltype(f(std::size_t(), std::size_t()))> results(band_count(size));
+	for_each_band(
+		size,
+		[&](std::size_t k, std::size_t first, std::size_t last)
+		{
+			results[k] = f(first, last);
+		});
+	return results;
+}
+
+// A line belongs to the band that contains its first byte.
+inline std::size_t line_start(std::string_view text, std::size_t pos)
+{
+	if (!pos)
+	{
+		return 0;
+	}
+	const std::size_t eol = text.find('\n', pos - 1);
+	return eol == std::string_view::npos ? text.size() : eol + 1;
+}
+
+} // namespace aoc
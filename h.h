@@ -15,13 +15,16 @@ int task_5_2(std::string_view input_file);
 int task_6_1(std::string_view input_file);
 int task_6_2(std::string_view input_file);
 int task_7_1(std::string_view input_file);
+int task_7_1_live(std::string_view input_file);
 int task_7_2(std::string_view input_file);
+int task_7_2_live(std::string_view input_file);
 int task_8_1(std::string_view input_file);
 int task_8_2(std::string_view input_file);
 int task_9_1(std::string_view input_file);
 int task_9_2(std::string_view input_file);
 int task_10_1(std::string_view input_file);
 int task_10_2(std::string_view input_file);
+int task_10_2_pick(std::string_view input_file);
 int task_11_1(std::string_view input_file);
 int task_11_2(std::string_view input_file);
 int task_12_1(std::string_view input_file);
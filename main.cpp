@@ -28,13 +28,16 @@ int main(int argc, char ** argv)
 		{"6.1", &task_6_1},
 		{"6.2", &task_6_2},
 		{"7.1", &task_7_1},
+		{"7.1.live", &task_7_1_live},
 		{"7.2", &task_7_2},
+		{"7.2.live", &task_7_2_live},
 		{"8.1", &task_8_1},
 		{"8.2", &task_8_2},
 		{"9.1", &task_9_1},
 		{"9.2", &task_9_2},
 		{"10.1", &task_10_1},
 		{"10.2", &task_10_2},
+		{"10.2.pick", &task_10_2_pick},
 		{"11.1", &task_11_1},
 		{"11.2", &task_11_2},
 		{"12.1", &task_12_1},
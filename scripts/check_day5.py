@@ -0,0 +1,115 @@
+#!/usr/bin/env python3
+"""Differential check of the day 5 tasks against a brute force solver.
+
+Usage: check_day5.py <path to aoc> [iterations] [seed]
+
+Generates small random almanacs, where every seed of every range can be mapped one by one, and compares the output
+of `aoc 5.1` and `aoc 5.2` with the brute force answers. Almanacs are placed around 2^32, 2^63 and the end of the
+64-bit range, and parts and seed ranges may end exactly at 2^64 - 1. Stops at the first mismatch and keeps its input.
+"""
+
+import os
+import random
+import subprocess
+import sys
+import tempfile
+
+CATEGORIES = ['seed', 'soil', 'fertilizer', 'water', 'light', 'temperature', 'humidity', 'location']
+
+# Values are 64-bit: the last value a range may cover is 2^64 - 2, since its end must fit too.
+LAST_END = 2**64 - 1
+
+
+def bases(size):
+    """Offsets that move an almanac across the 32-bit and 63-bit boundaries and up to the end of the 64-bit range,
+    while keeping its spans small enough for the brute force."""
+    return [0, 2**32 - size, 2**63 - size, 2**63, LAST_END - 3 * size]
+
+
+def generate(rng, size):
+    choices = bases(size)
+    base = rng.choice(choices)
+    seeds = []
+    for _ in range(rng.randint(1, 6)):
+        seeds += [base + rng.randint(0, size), rng.randint(1, size)]
+    if rng.random() < 0.2:
+        length = rng.randint(1, size)
+        seeds += [LAST_END - length, length]
+    maps = []
+    for _ in CATEGORIES[1:]:
+        # Most parts map within the almanac's region; some jump to another one, and every map may use the last
+        # values before 2^64 as source or destination.
+        dst_base = base if rng.random() < 0.7 else rng.choice(choices)
+        entries = []
+        pos = rng.randint(0, size // 10)
+        while pos < 2 * size and len(entries) < 8:
+            length = rng.randint(1, size // 4)
+            entries.append((dst_base + rng.randint(0, 2 * size), base + pos, length))
+            pos += length + rng.randint(0, size // 5)
+        if rng.random() < 0.3:
+            length = rng.randint(1, size // 4)
+            entries.append((LAST_END - length, base + pos, length))
+        if rng.random() < 0.3 and base + pos + size // 4 < LAST_END - size // 4:
+            length = rng.randint(1, size // 4)
+            entries.append((base + rng.randint(0, 2 * size), LAST_END - length, length))
+        rng.shuffle(entries)
+        maps.append(entries)
+    return seeds, maps
+
+
+def render(seeds, maps):
+    lines = ['seeds: ' + ' '.join(map(str, seeds)), '']
+    for source, destination, entries in zip(CATEGORIES, CATEGORIES[1:], maps):
+        lines.append(f'{source}-to-{destination} map:')
+        lines += [f'{dst} {src} {length}' for dst, src, length in entries]
+        lines.append('')
+    return '\n'.join(lines)
+
+
+def location(maps, value):
+    for entries in maps:
+        for dst, src, length in entries:
+            if src <= value < src + length:
+                value += dst - src
+                break
+    return value
+
+
+def brute_force(seeds, maps):
+    part1 = min(location(maps, seed) for seed in seeds)
+    part2 = min(
+        location(maps, seed)
+        for first, length in zip(seeds[::2], seeds[1::2])
+        for seed in range(first, first + length))
+    return part1, part2
+
+
+# The answer is the last line; 5.1 prints its seeds and locations before it.
+def run(aoc, task, path):
+    return int(subprocess.run([aoc, task, path], capture_output=True, check=True, text=True).stdout.split()[-1])
+
+
+def main():
+    if len(sys.argv) < 2:
+        sys.exit(__doc__)
+    aoc = sys.argv[1]
+    iterations = int(sys.argv[2]) if len(sys.argv) > 2 else 200
+    rng = random.Random(int(sys.argv[3]) if len(sys.argv) > 3 else 0)
+
+    for iteration in range(iterations):
+        seeds, maps = generate(rng, rng.choice([10, 50, 200]))
+        with tempfile.NamedTemporaryFile('w', suffix='.txt', delete=False) as input_file:
+            input_file.write(render(seeds, maps))
+        expected = brute_force(seeds, maps)
+        try:
+            actual = run(aoc, '5.1', input_file.name), run(aoc, '5.2', input_file.name)
+        except subprocess.CalledProcessError as error:
+            sys.exit(f'Failure on iteration {iteration} ({input_file.name}): {error.stderr.strip()}')
+        if actual != expected:
+            sys.exit(f'Mismatch on iteration {iteration} ({input_file.name}): expected {expected}, got {actual}')
+        os.unlink(input_file.name)
+    print(f'{iterations} almanacs match')
+
+
+if __name__ == '__main__':
+    main()